@@ -0,0 +1,1324 @@
+/*
+Benchmarks and correctness checks on the default Mancala board.
+Perft: leaf counts of the move tree from the start position against known
+values, and move generation speed.
+Search: nodes and time for Bot::search to reach a fixed depth from each of a
+standard set of positions (the start and short fixed-seed random openings).
+Sowing: checks Mancala moves against a stone by stone reference of the rules
+on several board types, then times make/undo with small and large pits.
+Move ordering: nodes for one thread to complete a fixed depth with each
+ordering heuristic added in turn, then with PVS and aspiration windows added
+to plain alpha-beta.  Root values and moves are compared for information
+only: cutoffs on table entries searched deeper than needed depend on the
+order positions are reached in, so they can legitimately change.
+Symmetry: distinct positions in the move tree with and without folding
+mirror images together, then searches with and without canonicalHash()
+table keys on a large and a small table.
+Dispatch: nodes/sec of iterative deepening through the virtual ABSearch
+interface against StaticSearch instantiated for DefaultMancala (values and
+moves must not change).
+Statistics: SearchResult's iterations and counters for the start position,
+and the cost of collecting the counters.
+Tablebase: checks an endgame tablebase against exhaustive searches, then
+compares searching endgames to depth with and without it.
+Solver: solves a small board exactly, checked against a tablebase covering
+every stone, then with that tablebase and across a checkpoint and resume.
+Pondering: depth reached per move by a SearchSession against an opponent that
+takes a while to reply, with and without pondering on the opponent's time.
+Tournament: games/sec of a fixed-depth bot match with more games played at
+once (results must not change).
+Scheduler: latency of many bot moves asked for at once, each searching
+with every hardware thread as Game::getAIMove() does, against sharing the
+threads through a SearchScheduler (which must never run more threads than
+it has).
+MCTS: rollouts/sec of Monte Carlo tree search at 1/2/4/... threads (every
+rollout must be counted once in the tree), then a short match against
+alpha-beta.
+Checkers: perft of the start position against published counts, then a
+search to depth, for a game with a larger branching factor than Mancala.
+Thread scaling: time for Bot::search to complete a fixed depth at 1/2/4/8/16 threads.
+
+Usage: bench [depth] [maxThreads] [--perft depth] [--json file] [--csv file]
+--json/--csv also write every number as (section, name, metric, value)
+records, for tracking results across commits.  Exits with 1 if a
+correctness check fails.
+*/
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include "src/Checkers.h"
+#include "src/Mancala.h"
+#include "src/Bot.h"
+#include "src/LatencyHistogram.h"
+#include "src/SearchScheduler.h"
+#include "src/SearchSession.h"
+#include "src/Solver.h"
+#include "src/Tournament.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using std::chrono::milliseconds;
+
+typedef ABSearchableState<DefaultMancala::board_t, action_t> state_type;
+
+const unsigned int BENCH_DEPTH = 14;
+const unsigned int BENCH_MAX_THREADS = 16;
+const unsigned int BENCH_POSITIONS = 6;
+const unsigned int BENCH_TABLEBASE_STONES = 10;
+const unsigned int BENCH_PERFT_DEPTH = 10;
+const size_t BENCH_TABLE_MB = 64;
+const size_t BENCH_SMALL_TABLE_MB = 1;
+const unsigned int BENCH_SYMMETRY_PLIES = 8;
+const unsigned int BENCH_TOURNAMENT_GAMES = 40;
+const milliseconds BENCH_PONDER_TIME = milliseconds(20); //per move, for both sides
+const unsigned int BENCH_PONDER_MOVES = 6;               //session moves per opening
+const unsigned int BENCH_TOURNAMENT_DEPTH = 6;
+const milliseconds BENCH_MCTS_TIME = milliseconds(500); //per thread count
+const size_t BENCH_MCTS_ROLLOUTS = 2000;                //per move in the match
+const unsigned int BENCH_MCTS_GAMES = 10;
+const unsigned int BENCH_SCHEDULER_MOVES = 32;             //bot moves asked for at once
+const milliseconds BENCH_SCHEDULER_TIME = milliseconds(100); //each due this long after the request
+const size_t BENCH_SOLVER_PITS = 4;
+const unsigned int BENCH_SOLVER_STONES = 2;     //per pit, for the board checked against the tablebase
+const unsigned int BENCH_SOLVER_BIG_STONES = 3; //per pit, for the board solved across a checkpoint
+//Leaf nodes of the default board's move tree at depths 1, 2, ...
+const size_t PERFT_COUNTS[] = {6, 35, 185, 942, 4690, 23233, 114430, 563055, 2763490, 13519607, 65870758};
+//Same for the Checkers start position (a capturing sequence is one move)
+const size_t CHECKERS_PERFT_COUNTS[] = {7, 49, 302, 1469, 7361, 36768, 179740, 845931, 3963680, 18391564};
+
+/*
+One number from a bench run.
+*/
+struct BenchRecord
+{
+    std::string section, name, metric;
+    double value;
+};
+
+std::vector<BenchRecord> benchRecords;
+size_t benchFailures = 0; //failed correctness checks
+
+int benchPlayer; //player searching at the root
+void record(const std::string &section, const std::string &name, const std::string &metric, double value);
+bool writeRecords(const std::string &path, bool json, unsigned int depth, unsigned int maxThreads);
+template <class M>
+size_t perft(M *game, unsigned int depth);
+void perftBenchmark(unsigned int maxDepth);
+void searchBenchmark(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+std::vector<DefaultMancala *> benchPositions(unsigned int count);
+SearchResult<action_t> searchToDepth(DefaultMancala *position, unsigned int depth, const SearchOptions &options,
+                                     size_t megabytes = BENCH_TABLE_MB);
+double timeToDepth(DefaultMancala *position, unsigned int depth, unsigned int threads);
+void compareSearches(const char *section, const char *title, const std::vector<const char *> &names,
+                     const std::vector<SearchOptions> &configs,
+                     const std::vector<DefaultMancala *> &positions, unsigned int depth);
+void orderingComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+void windowComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+void symmetryComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+void distinctPositions(DefaultMancala *game, unsigned int depth, std::set<size_t> &hashes, std::set<size_t> &canonical);
+void dispatchComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+float benchUtility(state_type *game);
+bool benchMaxLayer(state_type *game);
+void sowingBenchmark();
+template <class M>
+size_t checkSowing(M &start, unsigned int games, std::mt19937 &random);
+template <class M>
+double makeUndoRate(M &start, unsigned int games, std::mt19937 &random);
+void referenceMove(std::vector<unsigned int> &board, int &turn, int &winner, unsigned int pit);
+void statsReport(const std::vector<DefaultMancala *> &positions, unsigned int depth);
+void tablebaseBenchmark(unsigned int depth);
+void solverBenchmark();
+void tournamentBenchmark(unsigned int maxThreads);
+void mctsBenchmark(unsigned int maxThreads);
+void schedulerBenchmark();
+void ponderBenchmark();
+void checkersBenchmark(unsigned int perftDepth, unsigned int depth);
+DefaultMancala *endgamePosition(unsigned int inPlay, std::mt19937 &random);
+
+/*
+benchUtility and benchMaxLayer for StaticSearch.
+*/
+struct BenchEvaluator
+{
+    float operator()(DefaultMancala *game) const
+    {
+        float utility = (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
+        return benchPlayer == 1 ? utility : -utility;
+    };
+};
+
+struct BenchLayers
+{
+    int color(DefaultMancala *game, int /*parentColor*/) const { return game->getTurn() == benchPlayer ? 1 : -1; };
+};
+
+/*
+Store difference and layers for player 1, for the solver's boards.
+*/
+typedef BasicMancala<BENCH_SOLVER_PITS> SolverMancala;
+
+struct SolverEvaluator
+{
+    float operator()(SolverMancala *game) const
+    {
+        return (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
+    };
+};
+
+struct SolverLayers
+{
+    int color(SolverMancala *game, int /*parentColor*/) const { return game->getTurn() == 1 ? 1 : -1; };
+};
+
+int main(int argc, char const *argv[])
+{
+    unsigned int depth = BENCH_DEPTH, maxThreads = BENCH_MAX_THREADS, perftDepth = BENCH_PERFT_DEPTH;
+    std::string jsonPath, csvPath;
+    for (int i = 1, number = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--json")
+            jsonPath = argv[++i];
+        else if (i + 1 < argc && arg == "--csv")
+            csvPath = argv[++i];
+        else if (i + 1 < argc && arg == "--perft")
+            perftDepth = atoi(argv[++i]);
+        else if (number++ == 0)
+            depth = atoi(argv[i]);
+        else
+            maxThreads = atoi(argv[i]);
+    }
+    std::vector<DefaultMancala *> positions = benchPositions(BENCH_POSITIONS);
+
+    perftBenchmark(perftDepth);
+    searchBenchmark(positions, depth);
+    sowingBenchmark();
+    orderingComparison(positions, depth);
+    windowComparison(positions, depth);
+    symmetryComparison(positions, depth);
+    dispatchComparison(positions, depth);
+    statsReport(positions, depth);
+    tablebaseBenchmark(depth);
+    solverBenchmark();
+    ponderBenchmark();
+    tournamentBenchmark(maxThreads);
+    schedulerBenchmark();
+    mctsBenchmark(maxThreads);
+    checkersBenchmark(perftDepth, depth);
+
+    printf("Thread scaling, time to depth %u over %zu positions (%u hardware threads)\n",
+           depth, positions.size(), std::thread::hardware_concurrency());
+    printf("%8s %12s %8s\n", "threads", "seconds", "speedup");
+    double baseTime = 0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double seconds = 0;
+        for (auto position : positions)
+            seconds += timeToDepth(position, depth, threads);
+        if (threads == 1)
+            baseTime = seconds;
+        printf("%8u %12.3f %8.2f\n", threads, seconds, baseTime / seconds);
+        record("threads", std::to_string(threads), "seconds", seconds);
+        record("threads", std::to_string(threads), "speedup", baseTime / seconds);
+    }
+
+    for (auto position : positions)
+        delete position;
+    if (!jsonPath.empty() && !writeRecords(jsonPath, true, depth, maxThreads))
+        printf("Cannot write %s\n", jsonPath.c_str());
+    if (!csvPath.empty() && !writeRecords(csvPath, false, depth, maxThreads))
+        printf("Cannot write %s\n", csvPath.c_str());
+    if (benchFailures > 0)
+        printf("%zu correctness checks FAILED\n", benchFailures);
+    return benchFailures > 0 ? 1 : 0;
+}
+
+/*
+Adds a number to the machine readable output.
+*/
+void record(const std::string &section, const std::string &name, const std::string &metric, double value)
+{
+    benchRecords.push_back({section, name, metric, value});
+}
+
+/*
+Writes benchRecords to path as JSON (with the run's settings) or as CSV.
+Returns false if path can't be written.
+*/
+bool writeRecords(const std::string &path, bool json, unsigned int depth, unsigned int maxThreads)
+{
+    FILE *file = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+    if (json)
+    {
+        fprintf(file, "{\n  \"depth\": %u,\n  \"max_threads\": %u,\n  \"hardware_threads\": %u,\n"
+                      "  \"results\": [",
+                depth, maxThreads, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < benchRecords.size(); i++)
+        {
+            const BenchRecord &r = benchRecords[i];
+            fprintf(file, "%s\n    {\"section\": \"%s\", \"name\": \"%s\", \"metric\": \"%s\", \"value\": %.15g}",
+                    i ? "," : "", r.section.c_str(), r.name.c_str(), r.metric.c_str(), r.value);
+        }
+        fprintf(file, "\n  ]\n}\n");
+    }
+    else
+    {
+        fprintf(file, "section,name,metric,value\n");
+        for (const BenchRecord &r : benchRecords)
+            fprintf(file, "\"%s\",\"%s\",\"%s\",%.15g\n", r.section.c_str(), r.name.c_str(), r.metric.c_str(),
+                    r.value);
+    }
+    if (file != stdout)
+        fclose(file);
+    return true;
+}
+
+/*
+Counts the leaves of the move tree from game to depth (games that end sooner
+add nothing), by make/undo.
+*/
+template <class M>
+size_t perft(M *game, unsigned int depth)
+{
+    if (depth == 0)
+        return 1;
+    if (game->getWinner() >= 0)
+        return 0;
+    ActionList<typename M::action_type> moves;
+    game->getValidMoves(moves);
+    if (depth == 1)
+        return moves.size();
+    size_t leaves = 0;
+    for (auto move : moves)
+    {
+        game->makeMove(move);
+        leaves += perft(game, depth - 1);
+        game->undoMove();
+    }
+    return leaves;
+}
+
+/*
+Perft of the start position on the compile-time and runtime boards, checked
+against PERFT_COUNTS.
+*/
+void perftBenchmark(unsigned int maxDepth)
+{
+    maxDepth = std::min<size_t>(maxDepth, sizeof(PERFT_COUNTS) / sizeof(PERFT_COUNTS[0]));
+    printf("Perft, start position\n");
+    printf("%6s %14s %10s %14s %8s\n", "depth", "leaves", "seconds", "leaves/sec", "result");
+    for (unsigned int depth = 1; depth <= maxDepth; depth++)
+    {
+        DefaultMancala fixed;
+        Mancala runtime;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t leaves = perft(&fixed, depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool pass = leaves == PERFT_COUNTS[depth - 1] && perft(&runtime, depth) == leaves;
+        benchFailures += !pass;
+        printf("%6u %14zu %10.3f %14.0f %8s\n", depth, leaves, seconds, leaves / seconds, pass ? "ok" : "WRONG");
+        std::string name = "depth " + std::to_string(depth);
+        record("perft", name, "leaves", leaves);
+        record("perft", name, "seconds", seconds);
+        record("perft", name, "pass", pass);
+    }
+    printf("\n");
+}
+
+/*
+Single threaded Bot::search to depth from each position on a cold table.
+*/
+void searchBenchmark(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    printf("Search, depth %u from %zu positions (1 thread)\n", depth, positions.size());
+    printf("%9s %14s %10s %14s %8s %6s\n", "position", "nodes", "seconds", "nodes/sec", "value", "move");
+    SearchOptions options;
+    options.threads = 1;
+    options.maxDepth = depth;
+    size_t totalNodes = 0;
+    double totalSeconds = 0;
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        SearchResult<action_t> result = searchToDepth(positions[i], depth, options);
+        totalNodes += result.nodes;
+        totalSeconds += result.seconds;
+        printf("%9zu %14zu %10.3f %14.0f %8.2f %6u\n", i, result.nodes, result.seconds,
+               result.nodes / result.seconds, result.value, result.move);
+        std::string name = "position " + std::to_string(i);
+        record("search", name, "nodes", result.nodes);
+        record("search", name, "seconds", result.seconds);
+        record("search", name, "value", result.value);
+        record("search", name, "move", result.move);
+    }
+    printf("%9s %14zu %10.3f %14.0f\n\n", "total", totalNodes, totalSeconds, totalNodes / totalSeconds);
+    record("search", "total", "nodes", totalNodes);
+    record("search", "total", "seconds", totalSeconds);
+    record("search", "total", "nodes_per_sec", totalNodes / totalSeconds);
+}
+
+/*
+Differential check and make/undo throughput of Mancala moves.
+*/
+void sowingBenchmark()
+{
+    std::mt19937 random(2022);
+    size_t mismatches = 0;
+    for (unsigned int size = MIN_BOARD_SIZE; size <= 8; size++)
+        for (unsigned int stones = 1; stones <= 12; stones += 3)
+        {
+            Mancala mancala(size, stones);
+            mismatches += checkSowing(mancala, 10, random);
+        }
+    DefaultMancala defaultMancala;
+    BasicMancala<6, 20> largePits;
+    BasicMancala<7, 18> widest; //16 pits
+    BasicMancala<4, 1> smallest;
+    mismatches += checkSowing(defaultMancala, 50, random);
+    mismatches += checkSowing(largePits, 50, random);
+    mismatches += checkSowing(widest, 50, random);
+    mismatches += checkSowing(smallest, 50, random);
+    printf("Sowing, differential check against the reference rules: %zu mismatches\n", mismatches);
+    benchFailures += mismatches > 0;
+    record("sowing", "reference", "mismatches", mismatches);
+
+    printf("%22s %14s\n", "board", "make+undo/sec");
+    Mancala runtime(6, 4), runtimeLarge(6, 20);
+    std::pair<const char *, double> rates[] = {{"Mancala(6, 4)", makeUndoRate(runtime, 300, random)},
+                                               {"Mancala(6, 20)", makeUndoRate(runtimeLarge, 300, random)},
+                                               {"DefaultMancala", makeUndoRate(defaultMancala, 300, random)},
+                                               {"BasicMancala<6, 20>", makeUndoRate(largePits, 300, random)}};
+    for (auto &rate : rates)
+    {
+        printf("%22s %14.0f\n", rate.first, rate.second);
+        record("sowing", rate.first, "make_undo_per_sec", rate.second);
+    }
+    printf("\n");
+}
+
+/*
+Plays random games from start, checking every move's board, turn, winner
+and hash against referenceMove() and that undoMove() restores the position.
+Returns the number of mismatches.
+*/
+template <class M>
+size_t checkSowing(M &start, unsigned int games, std::mt19937 &random)
+{
+    size_t mismatches = 0;
+    for (unsigned int game = 0; game < games; game++)
+    {
+        M *mancala = start.clone();
+        std::vector<unsigned int> board(mancala->getSize());
+        for (size_t i = 0; i < board.size(); i++)
+            board[i] = mancala->getState(i);
+        int turn = mancala->getTurn(), winner = mancala->getWinner();
+        while (mancala->getWinner() < 0)
+        {
+            ActionList<action_t> moves;
+            mancala->getValidMoves(moves);
+            action_t move = moves[random() % moves.size()];
+            //Every move must undo cleanly
+            for (action_t other : moves)
+            {
+                size_t hash = mancala->hash();
+                mancala->makeMove(other);
+                mancala->undoMove();
+                bool same = mancala->hash() == hash && mancala->getTurn() == turn;
+                for (size_t i = 0; i < board.size(); i++)
+                    same = same && mancala->getState(i) == board[i];
+                mismatches += !same;
+            }
+            mancala->makeMove(move);
+            referenceMove(board, turn, winner, move);
+            M *fresh = mancala->clone(); //hash computed from scratch
+            bool same = mancala->getTurn() == turn && mancala->getWinner() == winner &&
+                        mancala->hash() == fresh->hash();
+            for (size_t i = 0; i < board.size(); i++)
+                same = same && mancala->getState(i) == board[i];
+            mismatches += !same;
+            delete fresh;
+        }
+        delete mancala;
+    }
+    return mismatches;
+}
+
+/*
+make/undo pairs per second over every move of random games.
+*/
+template <class M>
+double makeUndoRate(M &start, unsigned int games, std::mt19937 &random)
+{
+    size_t pairs = 0;
+    double seconds = 0;
+    for (unsigned int game = 0; game < games; game++)
+    {
+        M *mancala = start.clone();
+        while (mancala->getWinner() < 0)
+        {
+            ActionList<action_t> moves;
+            mancala->getValidMoves(moves);
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            for (int repeat = 0; repeat < 100; repeat++)
+                for (action_t move : moves)
+                {
+                    mancala->makeMove(move);
+                    mancala->undoMove();
+                }
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            pairs += 100 * moves.size();
+            mancala->makeMove(moves[random() % moves.size()]);
+        }
+        delete mancala;
+    }
+    return pairs / seconds;
+}
+
+/*
+The rules, one stone at a time.
+*/
+void referenceMove(std::vector<unsigned int> &board, int &turn, int &winner, unsigned int pit)
+{
+    unsigned int size = board.size(), store1 = size / 2 - 1, store2 = size - 1;
+    unsigned int stones = board[pit];
+    board[pit] = 0;
+    while (stones > 0)
+    {
+        pit = (pit + 1) % size;
+        if ((turn == 1 && pit != store2) || (turn == 2 && pit != store1))
+        {
+            board[pit]++;
+            stones--;
+        }
+    }
+    //Capture on the mover's side
+    bool ownSide = turn == 1 ? pit < store1 : pit > store1 && pit < store2;
+    if (ownSide && board[pit] == 1 && board[store2 - pit - 1] > 0)
+    {
+        unsigned int store = turn == 1 ? store1 : store2;
+        board[store] += board[store2 - pit - 1] + 1;
+        board[pit] = 0;
+        board[store2 - pit - 1] = 0;
+    }
+    //Sweep once a side is empty
+    unsigned int side1 = 0, side2 = 0;
+    for (unsigned int i = 0; i < store1; i++)
+    {
+        side1 += board[i];
+        side2 += board[store1 + 1 + i];
+    }
+    if (side1 == 0 || side2 == 0)
+    {
+        for (unsigned int i = 0; i < store1; i++)
+        {
+            board[store1] += board[i];
+            board[store2] += board[store1 + 1 + i];
+            board[i] = 0;
+            board[store1 + 1 + i] = 0;
+        }
+        winner = board[store1] > board[store2] ? 1 : board[store2] > board[store1] ? 2 : 0;
+    }
+    if (pit != (turn == 1 ? store1 : store2))
+        turn = turn % 2 + 1;
+}
+
+/*
+Iterations and counters of a search of the start position, then nodes/sec
+over all positions with and without counting stats.
+*/
+void statsReport(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    SearchOptions options;
+    options.threads = 1;
+    options.maxDepth = depth;
+    options.stats = true;
+    SearchResult<action_t> result = searchToDepth(positions[0], depth, options);
+    printf("Statistics, start position to depth %u (1 thread)\n", depth);
+    printf("%6s %10s %12s %10s\n", "depth", "value", "nodes", "seconds");
+    for (const IterationStats &iteration : result.iterations)
+        printf("%6u %10.2f %12zu %10.4f\n", iteration.depth, iteration.value, iteration.nodes, iteration.seconds);
+    printf("nodes %zu, leaves %zu, cutoffs %zu (%.1f%% by the first move), table hits %.1f%% of %zu probes, "
+           "branching factor %.2f\n",
+           result.nodes, result.stats.leaves, result.stats.cutoffs, 100 * result.stats.firstMoveCutoffRate(),
+           100 * result.stats.ttHitRate(), result.stats.ttProbes, result.branchingFactor());
+    for (const IterationStats &iteration : result.iterations)
+        record("stats", "depth " + std::to_string(iteration.depth), "seconds", iteration.seconds);
+    record("stats", "start", "first_move_cutoff_rate", result.stats.firstMoveCutoffRate());
+    record("stats", "start", "tt_hit_rate", result.stats.ttHitRate());
+    record("stats", "start", "branching_factor", result.branchingFactor());
+
+    printf("%12s %14s %10s %14s\n", "stats", "nodes", "seconds", "nodes/sec");
+    for (int collect = 0; collect < 2; collect++)
+    {
+        options.stats = collect;
+        size_t nodes = 0;
+        double seconds = 0;
+        for (auto position : positions)
+        {
+            result = searchToDepth(position, depth, options);
+            nodes += result.nodes;
+            seconds += result.seconds;
+        }
+        printf("%12s %14zu %10.3f %14.0f\n", collect ? "on" : "off", nodes, seconds, nodes / seconds);
+        record("stats", collect ? "on" : "off", "nodes_per_sec", nodes / seconds);
+    }
+    printf("\n");
+}
+
+/*
+Generates a tablebase, checks random endgames against searches to the end of
+the game, then searches endgames with more stones to depth with and without it.
+*/
+void tablebaseBenchmark(unsigned int depth)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "bench.mancalatb").string();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    MancalaTablebase::generate<DefaultMancala>(path, DEFAULT_SIZE, BENCH_TABLEBASE_STONES);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto tablebase = std::make_shared<const MancalaTablebase>(path);
+    printf("Tablebase, %zu positions with up to %u stones in play generated in %.2fs\n",
+           tablebase->getEntryCount(), BENCH_TABLEBASE_STONES, seconds);
+    record("tablebase", "generate", "seconds", seconds);
+
+    std::mt19937 random(2022);
+    size_t mismatches = 0, checked = 0;
+    for (unsigned int inPlay = 2; inPlay <= BENCH_TABLEBASE_STONES; inPlay++)
+        for (int i = 0; i < 20; i++, checked++)
+        {
+            DefaultMancala *position = endgamePosition(inPlay, random);
+            TranspositionTable table(16);
+            benchPlayer = position->getTurn();
+            //Deep enough to reach the end of every game
+            float value = StaticSearch<DefaultMancala, BenchEvaluator, BenchLayers>::SearchDepth(
+                              position, BenchEvaluator(), inPlay * DEFAULT_SIZE * 2, DEFAULT_PRECISION,
+                              BenchLayers(), &table)
+                              .value;
+            int stores = position->getPlayer1Score() - position->getPlayer2Score(), exact;
+            tablebase->probe(position->getBoard(), position->getTurn(), exact);
+            if (value != (benchPlayer == 1 ? stores : -stores) + exact)
+                mismatches++;
+            //resolveExact() and undoMove() must leave the position as it was
+            size_t hash = position->hash();
+            DefaultMancala::board_t board = position->getBoard();
+            position->setTablebase(tablebase);
+            if (!position->resolveExact() || !position->isABTerminalState())
+                mismatches++;
+            position->undoMove();
+            if (position->hash() != hash || position->getBoard() != board || position->getWinner() >= 0)
+                mismatches++;
+            delete position;
+        }
+    printf("Tablebase, %zu endgames checked against searches to the end of the game: %zu mismatches\n",
+           checked, mismatches);
+    benchFailures += mismatches > 0;
+    record("tablebase", "exhaustive", "mismatches", mismatches);
+
+    printf("Tablebase, search to depth %u over %u endgames with %u stones in play (1 thread)\n",
+           depth, BENCH_POSITIONS, BENCH_TABLEBASE_STONES * 2);
+    printf("%12s %14s %10s\n", "search", "nodes", "seconds");
+    std::vector<DefaultMancala *> endgames;
+    for (unsigned int i = 0; i < BENCH_POSITIONS; i++)
+        endgames.push_back(endgamePosition(BENCH_TABLEBASE_STONES * 2, random));
+    for (int useTablebase = 0; useTablebase < 2; useTablebase++)
+    {
+        SearchOptions options;
+        options.threads = 1;
+        options.maxDepth = depth;
+        size_t nodes = 0;
+        seconds = 0;
+        for (auto position : endgames)
+        {
+            position->setTablebase(useTablebase ? tablebase : nullptr);
+            SearchResult<action_t> result = searchToDepth(position, depth, options);
+            nodes += result.nodes;
+            seconds += result.seconds;
+        }
+        printf("%12s %14zu %10.3f\n", useTablebase ? "tablebase" : "none", nodes, seconds);
+        record("tablebase", useTablebase ? "tablebase" : "none", "nodes", nodes);
+        record("tablebase", useTablebase ? "tablebase" : "none", "seconds", seconds);
+    }
+    for (auto position : endgames)
+        delete position;
+    std::filesystem::remove(path);
+    printf("\n");
+}
+
+/*
+Solves a small board from the start and checks the value of every first move
+against a tablebase covering all its stones.  Then solves a bigger board with
+and without that tablebase, and again stopped halfway and resumed from a
+checkpoint (values must not change).
+*/
+void solverBenchmark()
+{
+    typedef Solver<SolverMancala, SolverEvaluator, SolverLayers> solver_type;
+    std::string path = (std::filesystem::temp_directory_path() / "bench_solver.mancalatb").string();
+    std::string checkpoint = (std::filesystem::temp_directory_path() / "bench_solver.checkpoint").string();
+    unsigned int tablebaseStones = BENCH_SOLVER_PITS * 2 * BENCH_SOLVER_STONES;
+    MancalaTablebase::generate<SolverMancala>(path, BENCH_SOLVER_PITS, tablebaseStones);
+    auto tablebase = std::make_shared<const MancalaTablebase>(path);
+
+    SolveOptions options;
+    options.megabytes = BENCH_TABLE_MB;
+    SolverMancala small(BENCH_SOLVER_PITS, BENCH_SOLVER_STONES);
+    SolveResult<action_t> result = solver_type(SolverEvaluator(), SolverLayers(), options).solve(&small);
+    ActionList<action_t> moves;
+    small.getValidMoves(moves);
+    size_t mismatches = !result.complete || result.moves.size() != moves.size();
+    int exact;
+    tablebase->probe(small.getBoard(), small.getTurn(), exact);
+    mismatches += result.value != exact;
+    for (size_t i = 0; i < result.moves.size(); i++)
+    {
+        SolverMancala child(small.getBoard(), small.getTurn());
+        child.makeMove(result.moves[i]);
+        tablebase->probe(child.getBoard(), child.getTurn(), exact);
+        float value = child.getPlayer1Score() - child.getPlayer2Score() + (child.getTurn() == 1 ? exact : -exact);
+        mismatches += result.values[i] != value;
+    }
+    printf("Solver, Mancala(%zu, %u) value %+g checked against the tablebase: %zu mismatches\n", BENCH_SOLVER_PITS,
+           BENCH_SOLVER_STONES, result.value, mismatches);
+    benchFailures += mismatches > 0;
+    record("solver", "tablebase", "mismatches", mismatches);
+
+    printf("Solver, Mancala(%zu, %u) from the start\n", BENCH_SOLVER_PITS, BENCH_SOLVER_BIG_STONES);
+    printf("%12s %8s %12s %12s %10s %14s %8s\n", "solve", "value", "nodes", "proven", "seconds", "proven/sec",
+           "result");
+    SolveResult<action_t> plain;
+    for (int run = 0; run < 3; run++)
+    {
+        const char *name = run == 0 ? "plain" : run == 1 ? "tablebase" : "resumed";
+        SolverMancala big(BENCH_SOLVER_PITS, BENCH_SOLVER_BIG_STONES);
+        if (run == 1)
+            big.setTablebase(tablebase);
+        SolveOptions runOptions = options;
+        bool interrupted = true;
+        if (run == 2)
+        {
+            //Stop halfway, then continue from the checkpoint with a new solver
+            SearchControl control;
+            control.setNodeLimit(plain.progress.nodes / 2);
+            runOptions.control = &control;
+            runOptions.checkpointPath = checkpoint;
+            interrupted = !solver_type(SolverEvaluator(), SolverLayers(), runOptions).solve(&big).complete;
+            runOptions.control = nullptr;
+            runOptions.resume = true;
+        }
+        result = solver_type(SolverEvaluator(), SolverLayers(), runOptions).solve(&big);
+        if (run == 0)
+            plain = result;
+        bool pass = interrupted && result.complete && result.values == plain.values && result.move == plain.move;
+        benchFailures += !pass;
+        printf("%12s %+8g %12zu %12zu %10.3f %14.0f %8s\n", name, result.value, result.progress.nodes,
+               result.progress.proven, result.progress.seconds, result.progress.provenPerSecond(),
+               pass ? "ok" : "WRONG");
+        record("solver", name, "nodes", result.progress.nodes);
+        record("solver", name, "proven", result.progress.proven);
+        record("solver", name, "seconds", result.progress.seconds);
+        record("solver", name, "pass", pass);
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(checkpoint);
+    printf("\n");
+}
+
+/*
+Random position with inPlay stones in the pits, some on each side, and the
+rest of the default board's stones split between the stores.
+*/
+DefaultMancala *endgamePosition(unsigned int inPlay, std::mt19937 &random)
+{
+    DefaultMancala::board_t board{};
+    const unsigned int store1 = DEFAULT_SIZE, store2 = DEFAULT_SIZE * 2 + 1;
+    do
+    {
+        board.fill(0);
+        for (unsigned int stone = 0; stone < inPlay; stone++)
+        {
+            unsigned int pit = random() % (DEFAULT_SIZE * 2);
+            board[pit < store1 ? pit : pit + 1]++;
+        }
+    } while (std::all_of(board.begin(), board.begin() + store1, [](uint8_t pit) { return pit == 0; }) ||
+             std::all_of(board.begin() + store1 + 1, board.end(), [](uint8_t pit) { return pit == 0; }));
+    unsigned int stored = DEFAULT_SIZE * 2 * DEFAULT_STONES - inPlay;
+    board[store1] = random() % (stored + 1);
+    board[store2] = stored - board[store1];
+    return new DefaultMancala(board, random() % 2 + 1);
+}
+
+/*
+Start position plus positions reached by short random openings (fixed seed).
+*/
+std::vector<DefaultMancala *> benchPositions(unsigned int count)
+{
+    std::mt19937 random(2022);
+    std::vector<DefaultMancala *> positions;
+    positions.push_back(new DefaultMancala());
+    while (positions.size() < count)
+    {
+        DefaultMancala *position = new DefaultMancala();
+        for (int ply = 0; ply < 6 && position->getWinner() < 0; ply++)
+        {
+            ActionList<action_t> moves;
+            position->getValidMoves(moves);
+            position->makeMove(moves[random() % moves.size()]);
+        }
+        if (position->getWinner() < 0)
+            positions.push_back(position);
+        else
+            delete position;
+    }
+    return positions;
+}
+
+/*
+Total nodes and time to depth for each configuration, and whether root
+values and moves match the first configuration's.  Not a correctness check:
+table cutoffs from deeper searches make results depend on the search order.
+*/
+void compareSearches(const char *section, const char *title, const std::vector<const char *> &names,
+                     const std::vector<SearchOptions> &configs,
+                     const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    printf("%s, nodes to depth %u over %zu positions (1 thread)\n", title, depth, positions.size());
+    printf("%12s %14s %10s %8s\n", "search", "nodes", "seconds", "results");
+    std::vector<SearchResult<action_t>> baseResults;
+    size_t baseNodes = 0;
+    for (size_t config = 0; config < configs.size(); config++)
+    {
+        SearchOptions options = configs[config];
+        options.threads = 1;
+        options.maxDepth = depth;
+        size_t nodes = 0;
+        double seconds = 0;
+        bool same = true;
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            SearchResult<action_t> result = searchToDepth(positions[i], depth, options);
+            nodes += result.nodes;
+            seconds += result.seconds;
+            if (config == 0)
+                baseResults.push_back(result);
+            else
+                same = same && baseResults[i].value == result.value && baseResults[i].move == result.move;
+        }
+        if (config == 0)
+            baseNodes = nodes;
+        printf("%12s %14zu %10.3f %8s  (%.1f%% of %s)\n", names[config], nodes, seconds,
+               same ? "same" : "differ", 100.0 * nodes / baseNodes, names[0]);
+        record(section, names[config], "nodes", nodes);
+        record(section, names[config], "seconds", seconds);
+    }
+    printf("\n");
+}
+
+/*
+Move ordering heuristics added one at a time.
+*/
+void orderingComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    std::vector<SearchOptions> configs(5);
+    for (unsigned int config = 0; config < configs.size(); config++)
+    {
+        configs[config].ordering.tableMove = config >= 1;
+        configs[config].ordering.hints = config >= 2;
+        configs[config].ordering.history = config >= 3;
+        configs[config].ordering.killers = config >= 4;
+    }
+    compareSearches("ordering", "Move ordering", {"none", "+table", "+hints", "+history", "+killers"},
+                    configs, positions, depth);
+}
+
+/*
+Plain alpha-beta against principal variation search and aspiration windows.
+*/
+void windowComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    std::vector<SearchOptions> configs(3);
+    for (unsigned int config = 0; config < configs.size(); config++)
+    {
+        configs[config].windows.pvs = config >= 1;
+        configs[config].windows.aspiration = config >= 2;
+    }
+    compareSearches("windows", "Search windows", {"alpha-beta", "+pvs", "+aspiration"}, configs, positions, depth);
+}
+
+/*
+Distinct positions within BENCH_SYMMETRY_PLIES of the start, then nodes, table
+hit rate and time to depth without and with symmetry, on a BENCH_TABLE_MB
+table and on a BENCH_SMALL_TABLE_MB one.
+*/
+void symmetryComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    std::set<size_t> hashes, canonical;
+    DefaultMancala start;
+    distinctPositions(&start, BENCH_SYMMETRY_PLIES, hashes, canonical);
+    printf("Symmetry, %zu distinct positions within %u plies of the start, %zu up to mirror images\n",
+           hashes.size(), BENCH_SYMMETRY_PLIES, canonical.size());
+    record("symmetry", "tree", "positions", hashes.size());
+    record("symmetry", "tree", "canonical_positions", canonical.size());
+    printf("%6s %9s %14s %10s %10s %8s\n", "table", "symmetry", "nodes", "hit rate", "seconds", "results");
+    for (size_t megabytes : {BENCH_TABLE_MB, BENCH_SMALL_TABLE_MB})
+    {
+        std::vector<SearchResult<action_t>> baseResults;
+        for (int symmetry = 0; symmetry < 2; symmetry++)
+        {
+            SearchOptions options;
+            options.threads = 1;
+            options.maxDepth = depth;
+            options.stats = true;
+            options.symmetry = symmetry;
+            size_t nodes = 0, probes = 0, hits = 0;
+            double seconds = 0;
+            bool same = true;
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                SearchResult<action_t> result = searchToDepth(positions[i], depth, options, megabytes);
+                nodes += result.nodes;
+                probes += result.stats.ttProbes;
+                hits += result.stats.ttHits;
+                seconds += result.seconds;
+                if (!symmetry)
+                    baseResults.push_back(result);
+                else
+                    same = same && baseResults[i].value == result.value && baseResults[i].move == result.move;
+            }
+            std::string name = std::to_string(megabytes) + "MB " + (symmetry ? "on" : "off");
+            printf("%4zuMB %9s %14zu %9.1f%% %10.3f %8s\n", megabytes, symmetry ? "on" : "off", nodes,
+                   100.0 * hits / probes, seconds, symmetry ? (same ? "same" : "differ") : "");
+            record("symmetry", name, "nodes", nodes);
+            record("symmetry", name, "tt_hit_rate", (double)hits / probes);
+            record("symmetry", name, "seconds", seconds);
+        }
+    }
+    printf("\n");
+}
+
+/*
+Adds the hashes and canonical hashes of every position within depth moves of game.
+*/
+void distinctPositions(DefaultMancala *game, unsigned int depth, std::set<size_t> &hashes, std::set<size_t> &canonical)
+{
+    bool mirrored;
+    hashes.insert(game->hash());
+    canonical.insert(game->canonicalHash(mirrored));
+    if (depth == 0 || game->getWinner() >= 0)
+        return;
+    ActionList<action_t> moves;
+    game->getValidMoves(moves);
+    for (action_t move : moves)
+    {
+        game->makeMove(move);
+        distinctPositions(game, depth - 1, hashes, canonical);
+        game->undoMove();
+    }
+}
+
+/*
+Single threaded iterative deepening to depth through both dispatch paths,
+which run the same search and must give the same results.
+*/
+void dispatchComparison(const std::vector<DefaultMancala *> &positions, unsigned int depth)
+{
+    printf("Dispatch, iterative deepening to depth %u over %zu positions (1 thread)\n", depth, positions.size());
+    printf("%12s %14s %10s %14s %8s\n", "search", "nodes", "seconds", "nodes/sec", "results");
+    std::vector<SearchResult<action_t>> virtualResults;
+    for (int path = 0; path < 2; path++)
+    {
+        size_t nodes = 0;
+        bool same = true;
+        double seconds = 0;
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            TranspositionTable table(64);
+            MoveOrdering<action_t> ordering;
+            benchPlayer = positions[i]->getTurn();
+            SearchResult<action_t> result;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (unsigned int d = 1; d <= depth; d++)
+            {
+                if (path == 0)
+                    result = ABSearch<DefaultMancala::board_t, action_t>::SearchDepth(
+                        positions[i], benchUtility, d, milliseconds(3600000), std::chrono::steady_clock::now(),
+                        DEFAULT_PRECISION, benchMaxLayer, &table, &result, nullptr, &ordering);
+                else
+                    result = StaticSearch<DefaultMancala, BenchEvaluator, BenchLayers>::SearchDepth(
+                        positions[i], BenchEvaluator(), d, DEFAULT_PRECISION, BenchLayers(), &table, &result,
+                        nullptr, &ordering);
+                nodes += result.nodes;
+            }
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (path == 0)
+                virtualResults.push_back(result);
+            else
+                same = same && virtualResults[i].value == result.value && virtualResults[i].move == result.move;
+        }
+        printf("%12s %14zu %10.3f %14.0f %8s\n", path == 0 ? "virtual" : "static", nodes, seconds,
+               nodes / seconds, same ? "same" : "DIFFER");
+        benchFailures += !same;
+        record("dispatch", path == 0 ? "virtual" : "static", "nodes_per_sec", nodes / seconds);
+    }
+    printf("\n");
+}
+
+/*
+Runs Bot::search to depth (options.maxDepth is replaced) on a cold table.
+Time with the result's seconds, which leave out allocating the table.
+*/
+SearchResult<action_t> searchToDepth(DefaultMancala *position, unsigned int depth, const SearchOptions &options,
+                                     size_t megabytes)
+{
+    TranspositionTable table(megabytes);
+    benchPlayer = position->getTurn();
+    SearchOptions depthOptions = options;
+    depthOptions.maxDepth = depth;
+    return Bot<DefaultMancala::board_t, action_t>::search(position, benchUtility, 1, milliseconds(3600000),
+                                                          DEFAULT_PRECISION, benchMaxLayer, &table, depthOptions);
+}
+
+/*
+Seconds for Bot::search to complete depth on a cold table.
+*/
+double timeToDepth(DefaultMancala *position, unsigned int depth, unsigned int threads)
+{
+    SearchOptions options;
+    options.threads = threads;
+    options.maxDepth = depth;
+    return searchToDepth(position, depth, options).seconds;
+}
+
+/*
+Deterministic evaluator: store difference for the player searching at the root.
+*/
+float benchUtility(state_type *game)
+{
+    DefaultMancala *mancala = (DefaultMancala *)game;
+    float utility = (float)mancala->getPlayer1Score() - (float)mancala->getPlayer2Score();
+    return benchPlayer == 1 ? utility : -utility;
+}
+
+bool benchMaxLayer(state_type *game)
+{
+    return ((DefaultMancala *)game)->getTurn() == benchPlayer;
+}
+
+/*
+benchUtility and benchMaxLayer for Player, as benchPlayer is shared by all games.
+*/
+template <int Player>
+float storeDifference(state_type *game)
+{
+    float utility = (float)((DefaultMancala *)game)->getPlayer1Score() - (float)((DefaultMancala *)game)->getPlayer2Score();
+    return Player == 1 ? utility : -utility;
+}
+
+template <int Player>
+bool playerToMove(state_type *game)
+{
+    return ((DefaultMancala *)game)->getTurn() == Player;
+}
+
+/*
+Plays the same fixed-depth match of store difference against itself with 1, 2,
+4, ... games at once and checks every run gives the same result.
+*/
+void tournamentBenchmark(unsigned int maxThreads)
+{
+    TournamentPlayer<DefaultMancala::board_t, action_t> player;
+    player.name = "bench";
+    player.utility[0] = storeDifference<1>;
+    player.utility[1] = storeDifference<2>;
+    player.maxLayer[0] = playerToMove<1>;
+    player.maxLayer[1] = playerToMove<2>;
+    player.time = milliseconds(60000); //only the depth limit should apply
+    player.options.maxDepth = BENCH_TOURNAMENT_DEPTH;
+    TournamentOptions options;
+    options.games = BENCH_TOURNAMENT_GAMES;
+    printf("Tournament, %u games at depth %u\n", options.games, BENCH_TOURNAMENT_DEPTH);
+    printf("%8s %12s %10s %12s\n", "at once", "W/D/L", "seconds", "games/sec");
+    TournamentResult first;
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        options.threads = threads;
+        DefaultMancala start;
+        TournamentResult result = Tournament<DefaultMancala::board_t, action_t>::run(&start, player, player, options);
+        if (threads == 1)
+            first = result;
+        bool same = result.wins == first.wins && result.draws == first.draws && result.moves == first.moves;
+        std::string score = std::to_string(result.wins) + "/" + std::to_string(result.draws) + "/" +
+                            std::to_string(result.losses);
+        printf("%8u %12s %10.3f %12.1f%s\n", threads, score.c_str(), result.seconds, result.gamesPerSecond(),
+               same ? "" : "  MISMATCH");
+        record("tournament", std::to_string(threads), "games_per_sec", result.gamesPerSecond());
+        benchFailures += !same;
+    }
+    printf("\n");
+}
+
+/*
+BENCH_SCHEDULER_MOVES bot moves from the bench positions, all asked for at
+once and due BENCH_SCHEDULER_TIME later.  First each runs on its own thread
+with the default SearchOptions (hardware_concurrency() threads each), then
+all go through one SearchScheduler with hardware_concurrency() threads,
+which is checked to never have more threads searching than that.
+*/
+void schedulerBenchmark()
+{
+    typedef DefaultMancala::board_t board_t;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    printf("Scheduler, %u moves at once due in %ldms (%u hardware threads)\n", BENCH_SCHEDULER_MOVES,
+           (long)BENCH_SCHEDULER_TIME.count(), threads);
+    printf("%12s %10s %10s %10s %8s %12s\n", "peak threads", "p50 ms", "p99 ms", "max ms", "missed", "mean depth");
+    std::vector<DefaultMancala *> positions = benchPositions(BENCH_POSITIONS);
+    for (int scheduled = 0; scheduled < 2; scheduled++)
+    {
+        //A game's table is kept between moves, so it is not allocated while the clock runs
+        std::vector<std::unique_ptr<TranspositionTable>> tables;
+        for (unsigned int i = 0; i < BENCH_SCHEDULER_MOVES; i++)
+            tables.emplace_back(new TranspositionTable(BENCH_SMALL_TABLE_MB));
+        LatencyHistogram latency;
+        std::atomic<size_t> missed{0}, depth{0}, searched{0};
+        std::atomic<unsigned int> busy{0}, peak{0};
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point deadline = start + BENCH_SCHEDULER_TIME;
+        auto move = [&](unsigned int index, unsigned int moveThreads, ThreadPool *pool, SearchControl *control)
+        {
+            unsigned int now = busy += moveThreads;
+            for (unsigned int before = peak; now > before && !peak.compare_exchange_weak(before, now);)
+                ;
+            std::unique_ptr<DefaultMancala> game(positions[index % positions.size()]->clone());
+            SearchOptions options;
+            options.threads = moveThreads;
+            options.pool = pool;
+            options.control = control; //the scheduler's deadline instead of thinkTime
+            bool player1 = game->getTurn() == 1;
+            try
+            {
+                SearchResult<action_t> result = Bot<board_t, action_t>::search(
+                    game.get(), player1 ? storeDifference<1> : storeDifference<2>, DEFAULT_DEPTH, BENCH_SCHEDULER_TIME,
+                    DEFAULT_PRECISION, player1 ? playerToMove<1> : playerToMove<2>, tables[index].get(), options);
+                depth += result.depth;
+                searched++;
+            }
+            catch (ABTimeout &)
+            {
+            }
+            busy -= moveThreads;
+            std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now();
+            latency.record(std::chrono::duration_cast<std::chrono::microseconds>(done - start));
+            missed += done > deadline;
+        };
+        if (scheduled)
+        {
+            SearchScheduler scheduler(threads);
+            for (unsigned int i = 0; i < BENCH_SCHEDULER_MOVES; i++)
+                scheduler.submit(deadline, [&move, i](unsigned int moveThreads, ThreadPool &pool,
+                                                      SearchControl &control)
+                                 { move(i, moveThreads, &pool, &control); });
+            scheduler.wait();
+        }
+        else
+        {
+            std::vector<std::thread> moves;
+            for (unsigned int i = 0; i < BENCH_SCHEDULER_MOVES; i++)
+                moves.emplace_back(move, i, threads, nullptr, nullptr);
+            for (auto &thread : moves)
+                thread.join();
+        }
+        bool withinPool = !scheduled || peak <= threads;
+        benchFailures += !withinPool;
+        const char *name = scheduled ? "scheduled" : "own";
+        std::string used = std::to_string(peak.load()) + (scheduled ? " of " + std::to_string(threads) : "");
+        printf("%12s %10.1f %10.1f %10.1f %8zu %12.2f  (%s)%s\n", used.c_str(),
+               latency.percentile(50).count() / 1000.0, latency.percentile(99).count() / 1000.0,
+               latency.getMax().count() / 1000.0, missed.load(), searched ? (double)depth / searched : 0, name,
+               withinPool ? "" : "  OVERSUBSCRIBED");
+        record("scheduler", name, "p50_ms", latency.percentile(50).count() / 1000.0);
+        record("scheduler", name, "p99_ms", latency.percentile(99).count() / 1000.0);
+        record("scheduler", name, "missed", missed);
+    }
+    for (auto position : positions)
+        delete position;
+    printf("\n");
+}
+
+/*
+MCTS from the start position for BENCH_MCTS_TIME at each thread count, then
+a match of MCTS with BENCH_MCTS_ROLLOUTS a move against a depth 4 search
+(one thread each, so the games are the same on every run).
+*/
+void mctsBenchmark(unsigned int maxThreads)
+{
+    typedef DefaultMancala::board_t board_t;
+    printf("MCTS, start position for %ldms (%u hardware threads)\n", (long)BENCH_MCTS_TIME.count(),
+           std::thread::hardware_concurrency());
+    printf("%8s %12s %14s %8s %10s %6s %8s\n", "threads", "rollouts", "rollouts/sec", "speedup", "nodes", "move",
+           "score");
+    double baseRate = 0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        DefaultMancala start;
+        MCTSOptions options;
+        options.threads = threads;
+        MCTSResult<action_t> result = MCTS<board_t, action_t>::search(&start, storeDifference<1>, BENCH_MCTS_TIME,
+                                                                      playerToMove<1>, nullptr, options);
+        size_t visits = 0;
+        for (size_t count : result.visits)
+            visits += count;
+        bool counted = visits == result.rollouts;
+        benchFailures += !counted;
+        if (threads == 1)
+            baseRate = result.rolloutsPerSecond();
+        printf("%8u %12zu %14.0f %8.2f %10zu %6u %8.3f%s\n", threads, result.rollouts, result.rolloutsPerSecond(),
+               result.rolloutsPerSecond() / baseRate, result.nodes, result.move, result.score,
+               counted ? "" : "  MISCOUNTED");
+        record("mcts", std::to_string(threads), "rollouts_per_sec", result.rolloutsPerSecond());
+        record("mcts", std::to_string(threads), "speedup", result.rolloutsPerSecond() / baseRate);
+    }
+
+    TournamentPlayer<board_t, action_t> mcts, alphaBeta;
+    for (auto player : {&mcts, &alphaBeta})
+    {
+        player->utility[0] = storeDifference<1>;
+        player->utility[1] = storeDifference<2>;
+        player->maxLayer[0] = playerToMove<1>;
+        player->maxLayer[1] = playerToMove<2>;
+        player->time = milliseconds(60000); //only the rollout and depth limits should apply
+    }
+    mcts.mcts = true;
+    mcts.mctsOptions.maxRollouts = BENCH_MCTS_ROLLOUTS;
+    alphaBeta.options.maxDepth = 4;
+    TournamentOptions options;
+    options.games = BENCH_MCTS_GAMES;
+    DefaultMancala start;
+    TournamentResult result = Tournament<board_t, action_t>::run(&start, mcts, alphaBeta, options);
+    printf("MCTS with %zu rollouts a move against depth 4: +%u =%u -%u, %.2fs\n", BENCH_MCTS_ROLLOUTS,
+           result.wins, result.draws, result.losses, result.seconds);
+    record("mcts", "match", "score", result.score());
+    printf("\n");
+}
+
+/*
+A SearchSession plays BENCH_PONDER_MOVES moves as player 2 from each opening
+against a depth 4 player that waits BENCH_PONDER_TIME before each move, like
+a human would.  Nodes per move include the ponder search on a hit.
+*/
+void ponderBenchmark()
+{
+    typedef DefaultMancala::board_t board_t;
+    printf("Pondering, %ldms a move against a waiting opponent, %u openings\n", (long)BENCH_PONDER_TIME.count(),
+           BENCH_POSITIONS);
+    printf("%8s %10s %12s %14s %10s\n", "ponder", "moves", "mean depth", "nodes/move", "hit rate");
+    std::vector<DefaultMancala *> positions = benchPositions(BENCH_POSITIONS);
+    for (int pondering = 0; pondering < 2; pondering++)
+    {
+        SearchOptions options;
+        options.threads = 1;
+        SearchOptions opponentOptions = options;
+        opponentOptions.maxDepth = 4;
+        size_t moves = 0, depth = 0, nodes = 0, hits = 0, misses = 0;
+        for (auto position : positions)
+        {
+            std::unique_ptr<DefaultMancala> game(position->clone());
+            SearchSession<board_t, action_t> session(storeDifference<2>, playerToMove<2>, DEFAULT_DEPTH,
+                                                     BENCH_PONDER_TIME, options);
+            for (unsigned int played = 0; game->getWinner() < 0 && played < BENCH_PONDER_MOVES;)
+            {
+                if (game->getTurn() == 2)
+                {
+                    SearchResult<action_t> result = session.search(game.get());
+                    game->makeMove(result.move);
+                    moves++;
+                    played++;
+                    depth += result.depth;
+                    nodes += result.nodes;
+                    if (pondering && game->getTurn() == 1 && game->getWinner() < 0)
+                        session.ponder(game.get());
+                    continue;
+                }
+                action_t move = Bot<board_t, action_t>::getMove(game.get(), storeDifference<1>, DEFAULT_DEPTH,
+                                                                BENCH_PONDER_TIME, DEFAULT_PRECISION,
+                                                                playerToMove<1>, nullptr, opponentOptions);
+                std::this_thread::sleep_for(BENCH_PONDER_TIME);
+                game->makeMove(move);
+            }
+            hits += session.getPonderHits();
+            misses += session.getPonderMisses();
+        }
+        double meanDepth = moves ? (double)depth / moves : 0, meanNodes = moves ? (double)nodes / moves : 0;
+        double hitRate = hits + misses ? (double)hits / (hits + misses) : 0;
+        printf("%8s %10zu %12.2f %14.0f %9.1f%%\n", pondering ? "on" : "off", moves, meanDepth, meanNodes,
+               100 * hitRate);
+        record("ponder", pondering ? "on" : "off", "mean_depth", meanDepth);
+        record("ponder", pondering ? "on" : "off", "nodes_per_move", meanNodes);
+        if (pondering)
+            record("ponder", "on", "hit_rate", hitRate);
+    }
+    for (auto position : positions)
+        delete position;
+    printf("\n");
+}
+
+/*
+Material for player 1, kings worth 1.5 men.
+*/
+float checkersMaterial(ABSearchableState<CheckersBoard, CheckersMove> *state)
+{
+    Checkers *game = (Checkers *)state;
+    if (game->getWinner() > 0)
+        return game->getWinner() == 1 ? 100 : -100;
+    return game->getPieceCount(1) + 0.5f * game->getKingCount(1) - game->getPieceCount(2) -
+           0.5f * game->getKingCount(2);
+}
+
+bool checkersPlayer1(ABSearchableState<CheckersBoard, CheckersMove> *state)
+{
+    return ((Checkers *)state)->getTurn() == 1;
+}
+
+/*
+Perft of the Checkers start position checked against CHECKERS_PERFT_COUNTS,
+then a single threaded search of it to depth on a cold table.
+*/
+void checkersBenchmark(unsigned int perftDepth, unsigned int depth)
+{
+    perftDepth = std::min<size_t>(perftDepth, sizeof(CHECKERS_PERFT_COUNTS) / sizeof(CHECKERS_PERFT_COUNTS[0]));
+    printf("Checkers perft, start position\n");
+    printf("%6s %14s %10s %14s %8s\n", "depth", "leaves", "seconds", "leaves/sec", "result");
+    for (unsigned int ply = 1; ply <= perftDepth; ply++)
+    {
+        Checkers game;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t leaves = perft(&game, ply);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool pass = leaves == CHECKERS_PERFT_COUNTS[ply - 1];
+        benchFailures += !pass;
+        printf("%6u %14zu %10.3f %14.0f %8s\n", ply, leaves, seconds, leaves / seconds, pass ? "ok" : "WRONG");
+        std::string name = "depth " + std::to_string(ply);
+        record("checkers_perft", name, "leaves", leaves);
+        record("checkers_perft", name, "seconds", seconds);
+        record("checkers_perft", name, "pass", pass);
+    }
+
+    Checkers game;
+    TranspositionTable table(64);
+    SearchOptions options;
+    options.threads = 1;
+    options.maxDepth = depth;
+    options.stats = true;
+    options.ordering.killers = true; //fewer nodes here, unlike Mancala
+    SearchResult<CheckersMove> result = Bot<CheckersBoard, CheckersMove>::search(
+        &game, checkersMaterial, 1, milliseconds(3600000), DEFAULT_PRECISION, checkersPlayer1, &table, options);
+    printf("Checkers search, start position to depth %u (1 thread): %zu nodes, %.3fs, %.0f nodes/sec, "
+           "branching factor %.2f, %.1f%% first move cutoffs, best %s\n\n",
+           result.depth, result.nodes, result.seconds, result.nodes / result.seconds, result.branchingFactor(),
+           100 * result.stats.firstMoveCutoffRate(), Checkers::moveString(result.move).c_str());
+    record("checkers_search", "start", "nodes", result.nodes);
+    record("checkers_search", "start", "seconds", result.seconds);
+    record("checkers_search", "start", "nodes_per_sec", result.nodes / result.seconds);
+    record("checkers_search", "start", "branching_factor", result.branchingFactor());
+}
@@ -0,0 +1,145 @@
+/*
+Plays Mancala bots against each other to compare utility functions.
+Runs a Tournament between two of the utility functions below from random
+openings, then prints the score, the Elo difference and an SPRT result.
+
+Usage: botBattle [games] [threads] [--a name] [--b name] [--mcts-a] [--mcts-b] [--guided]
+                 [--depth n] [--time ms] [--nodes n] [--plies n] [--sprt elo0 elo1]
+Utility functions: stores, utility1
+--mcts-a/--mcts-b make that player search with MCTS instead of alpha-beta
+(--guided: with rollouts guided by its utility function).
+--depth, --time and --nodes (rollouts for MCTS) limit every move
+(defaults: depth 8, 1000ms).
+--sprt stops the match once the test decides.
+*/
+
+#include <iostream>
+#include <string>
+#include "src/Mancala.h"
+#include "src/MancalaEvaluators.h"
+#include "src/Tournament.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using std::chrono::milliseconds;
+
+typedef TournamentPlayer<DefaultMancala::board_t, action_t> player_type;
+
+const unsigned int BATTLE_DEPTH = 8;
+const milliseconds BATTLE_TIME = milliseconds(1000);
+
+/*
+Player using the named utility function.  Throws invalid_argument for unknown names.
+*/
+player_type makePlayer(const std::string &name)
+{
+    player_type player;
+    player.name = name;
+    if (name == "stores")
+    {
+        player.utility[0] = stores<1>;
+        player.utility[1] = stores<2>;
+    }
+    else if (name == "utility1")
+    {
+        player.utility[0] = utility1<1>;
+        player.utility[1] = utility1<2>;
+    }
+    else
+        throw std::invalid_argument("unknown utility function " + name);
+    player.maxLayer[0] = maxLayer<1>;
+    player.maxLayer[1] = maxLayer<2>;
+    player.time = BATTLE_TIME;
+    player.options.maxDepth = BATTLE_DEPTH;
+    return player;
+}
+
+int main(int argc, char const *argv[])
+{
+    TournamentOptions options;
+    std::string nameA = "utility1", nameB = "stores";
+    unsigned int depth = BATTLE_DEPTH;
+    size_t nodes = 0;
+    milliseconds time = BATTLE_TIME;
+    bool sprt = false, mctsA = false, mctsB = false, guided = false;
+    for (int i = 1, number = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--a")
+            nameA = argv[++i];
+        else if (i + 1 < argc && arg == "--b")
+            nameB = argv[++i];
+        else if (arg == "--mcts-a")
+            mctsA = true;
+        else if (arg == "--mcts-b")
+            mctsB = true;
+        else if (arg == "--guided")
+            guided = true;
+        else if (i + 1 < argc && arg == "--depth")
+            depth = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--time")
+            time = milliseconds(atoi(argv[++i]));
+        else if (i + 1 < argc && arg == "--nodes")
+            nodes = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--plies")
+            options.openingPlies = atoi(argv[++i]);
+        else if (i + 2 < argc && arg == "--sprt")
+        {
+            options.elo0 = atof(argv[++i]);
+            options.elo1 = atof(argv[++i]);
+            options.sprtStop = sprt = true;
+        }
+        else if (number++ == 0)
+            options.games = atoi(argv[i]);
+        else
+            options.threads = atoi(argv[i]);
+    }
+
+    player_type a, b;
+    try
+    {
+        a = makePlayer(nameA);
+        b = makePlayer(nameB);
+    }
+    catch (std::invalid_argument &e)
+    {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    for (player_type *player : {&a, &b})
+    {
+        player->options.maxDepth = depth;
+        player->options.maxNodes = nodes;
+        player->time = time;
+        player->mctsOptions.maxRollouts = nodes;
+        player->mctsOptions.guidedRollouts = guided;
+    }
+    a.mcts = mctsA;
+    b.mcts = mctsB;
+    if (mctsA)
+        a.name = "mcts:" + a.name;
+    if (mctsB)
+        b.name = "mcts:" + b.name;
+
+    DefaultMancala start;
+    TournamentResult result;
+    try
+    {
+        result = Tournament<DefaultMancala::board_t, action_t>::run(&start, a, b, options);
+    }
+    catch (std::invalid_argument &e)
+    {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    printf("%s vs %s: %u games (+%u =%u -%u), score %.1f%%, Elo %+.1f +/- %.1f\n", a.name.c_str(),
+           b.name.c_str(), result.games(), result.wins, result.draws, result.losses, 100 * result.score(),
+           result.elo(), result.eloMargin());
+    int decision = result.sprt(options.elo0, options.elo1, options.alpha, options.beta);
+    printf("SPRT elo0 %.1f elo1 %.1f: LLR %.2f (%.2f, %.2f), %s%s\n", options.elo0, options.elo1,
+           result.llr(options.elo0, options.elo1), std::log(options.beta / (1 - options.alpha)),
+           std::log((1 - options.beta) / options.alpha),
+           decision > 0 ? "H1 accepted" : decision < 0 ? "H0 accepted" : "undecided", sprt ? "" : " (not stopping)");
+    printf("%zu moves (%zu without a search result), %.2fs, %.1f games/sec\n", result.moves,
+           result.fallbackMoves, result.seconds, result.gamesPerSecond());
+}
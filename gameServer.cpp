@@ -0,0 +1,349 @@
+/*
+Hosts many Mancala games against the bot at once, for clients speaking a
+line protocol over a Unix domain socket (or stdin/stdout).  Every bot move
+is searched through one SearchScheduler, which divides a fixed number of
+threads between the moves waiting, earliest deadline first, so concurrent
+games never oversubscribe the machine.  Each bot move's latency (request to
+reply) and the time it waited for threads are kept in histograms.
+
+Usage: gameServer [--socket path | --stdio] [--threads n] [--table MB]
+--threads is the search threads shared by every game (default: hardware threads).
+--table is the transposition table size of each game (default 1MB).
+
+Protocol: one command a line, answered by one line unless noted.
+  new               -> session <id>                       a new game from the start position
+  move <id> <pit>   -> ok <id>                            plays pit for the side to move
+  bot <id> [ms]     -> bot <id> <pit> <depth> <threads> <latency us>
+                       the bot plays the side to move, replying within ms (default 100)
+  board <id>        -> board <id> <turn> <winner> <pits and stores...>
+  close <id>        -> closed <id>
+  stats             -> counters and latency percentiles, then "end"
+  histogram         -> "<bucket limit us> <latency count> <wait count>" lines, then "end"
+  quit              -> closes the connection
+Errors are answered with "error <id> <message>" (id 0 if there is none).
+A session takes no other commands until its bot move is answered; bot
+replies come when the search is done, so they can overtake the replies to
+commands sent later for other sessions.
+*/
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "src/LatencyHistogram.h"
+#include "src/LineStream.h"
+#include "src/Mancala.h"
+#include "src/MancalaEvaluators.h"
+#include "src/SearchScheduler.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+typedef DefaultMancala::board_t board_t;
+
+const size_t SERVER_TABLE_MB = 1;                                  //per game
+const milliseconds SERVER_BOT_TIME = milliseconds(100);            //bot reply time when not given
+const milliseconds SERVER_REPLY_MARGIN = milliseconds(2);          //of the reply time, kept for replying
+const milliseconds SERVER_FALLBACK_TIME = milliseconds(1000);      //for a depth 1 search if that ran out
+const double SERVER_PERCENTILES[] = {50, 90, 99, 99.9};
+
+/*
+One game, with the table its bot moves share.
+*/
+struct Session
+{
+    DefaultMancala game;
+    TranspositionTable table;
+    bool busy = false; //a bot move is being searched
+
+    Session(size_t megabytes) : table(megabytes){};
+};
+
+/*
+A client and its games.  lock guards sessions and their busy flags.
+*/
+struct Connection
+{
+    LineStream stream;
+    std::mutex lock;
+    std::map<unsigned int, std::shared_ptr<Session>> sessions;
+    unsigned int nextId = 1;
+
+    Connection(int in, int out, bool owned) : stream(in, out, owned){};
+};
+
+class GameServer
+{
+public:
+    GameServer(unsigned int threads, size_t megabytes) : megabytes{megabytes}, scheduler(threads){};
+
+    void serve(std::shared_ptr<Connection> connection);
+    unsigned int getThreads() const { return scheduler.getThreads(); };
+    void wait() { scheduler.wait(); }; //for the bot moves still being searched
+
+private:
+    size_t megabytes;
+    LatencyHistogram latency, waiting;
+    std::atomic<size_t> requests{0}, missed{0}, sessions{0};
+    SearchScheduler scheduler; //last, so its jobs finish before the rest is destroyed
+
+    std::string command(std::shared_ptr<Connection> connection, const std::string &line);
+    std::string botMove(std::shared_ptr<Connection> connection, unsigned int id, milliseconds time);
+    void sendStats(Connection &connection);
+    void sendHistogram(Connection &connection);
+};
+
+/*
+Answers connection's commands until it quits or closes, then ends its games.
+*/
+void GameServer::serve(std::shared_ptr<Connection> connection)
+{
+    std::string line;
+    while (connection->stream.readLine(line))
+    {
+        std::string command = line.substr(0, line.find(' '));
+        if (command == "quit")
+            break;
+        if (command == "stats")
+            sendStats(*connection);
+        else if (command == "histogram")
+            sendHistogram(*connection);
+        else if (!line.empty())
+        {
+            std::string reply = this->command(connection, line);
+            if (!reply.empty())
+                connection->stream.writeLine(reply);
+        }
+    }
+    std::lock_guard<std::mutex> guard(connection->lock);
+    sessions -= connection->sessions.size();
+    connection->sessions.clear(); //bot moves still searching keep their session
+}
+
+/*
+Runs a session command and returns its reply ("" if it comes later).
+*/
+std::string GameServer::command(std::shared_ptr<Connection> connection, const std::string &line)
+{
+    std::istringstream in(line);
+    std::string command;
+    unsigned int id = 0;
+    in >> command;
+    std::lock_guard<std::mutex> guard(connection->lock);
+    if (command == "new")
+    {
+        id = connection->nextId++;
+        connection->sessions[id] = std::make_shared<Session>(megabytes);
+        sessions++;
+        return "session " + std::to_string(id);
+    }
+
+    std::string error = "error " + std::to_string(id) + " ";
+    if (command != "move" && command != "bot" && command != "board" && command != "close")
+        return error + "unknown command " + command;
+    if (!(in >> id))
+        return error + "missing session";
+    error = "error " + std::to_string(id) + " ";
+    auto found = connection->sessions.find(id);
+    if (found == connection->sessions.end())
+        return error + "no such session";
+    Session &session = *found->second;
+    if (session.busy)
+        return error + "busy";
+
+    if (command == "close")
+    {
+        connection->sessions.erase(found);
+        sessions--;
+        return "closed " + std::to_string(id);
+    }
+    if (command == "board")
+    {
+        std::string reply = "board " + std::to_string(id) + " " + std::to_string(session.game.getTurn()) + " " +
+                            std::to_string(session.game.getWinner());
+        for (unsigned int stones : session.game.getBoard())
+            reply += " " + std::to_string(stones);
+        return reply;
+    }
+    if (session.game.getWinner() >= 0)
+        return error + "game over";
+    if (command == "move")
+    {
+        action_t pit;
+        if (!(in >> pit))
+            return error + "missing pit";
+        try
+        {
+            session.game.makeMove(pit);
+        }
+        catch (std::invalid_argument &e)
+        {
+            return error + e.what();
+        }
+        return "ok " + std::to_string(id);
+    }
+    long time = SERVER_BOT_TIME.count();
+    in >> time;
+    if (time <= 0)
+        return error + "reply time must be positive";
+    return botMove(connection, id, milliseconds(time));
+}
+
+/*
+Queues a bot move for session id, due time from now.  Replies when the
+search is done.  Called with connection->lock held.
+*/
+std::string GameServer::botMove(std::shared_ptr<Connection> connection, unsigned int id, milliseconds time)
+{
+    std::shared_ptr<Session> session = connection->sessions[id];
+    session->busy = true; //the search has the game to itself
+    steady_clock::time_point arrival = steady_clock::now(), deadline = arrival + time;
+    requests++;
+    //The scheduler stops the search in time to reply
+    scheduler.submit(deadline - SERVER_REPLY_MARGIN, [this, connection, session, id, arrival, deadline](
+                                                         unsigned int threads, ThreadPool &pool, SearchControl &control)
+                     {
+                         waiting.record(std::chrono::duration_cast<microseconds>(steady_clock::now() - arrival));
+                         SearchOptions options;
+                         options.threads = threads;
+                         options.pool = &pool;
+                         options.control = &control;
+                         bool player1 = session->game.getTurn() == 1;
+                         std::string reply;
+                         try
+                         {
+                             SearchResult<action_t> result;
+                             try
+                             {
+                                 result = Bot<board_t, action_t>::search(
+                                     &session->game, player1 ? utility1<1> : utility1<2>, DEFAULT_DEPTH, DEFAULT_TIME,
+                                     DEFAULT_PRECISION, player1 ? maxLayer<1> : maxLayer<2>, &session->table,
+                                     options);
+                             }
+                             catch (ABTimeout &)
+                             {
+                                 //Out of time before depth 1: reply late rather than not at all
+                                 options.maxDepth = DEFAULT_DEPTH;
+                                 options.control = nullptr;
+                                 result = Bot<board_t, action_t>::search(
+                                     &session->game, player1 ? utility1<1> : utility1<2>, DEFAULT_DEPTH,
+                                     SERVER_FALLBACK_TIME, DEFAULT_PRECISION, player1 ? maxLayer<1> : maxLayer<2>,
+                                     &session->table, options);
+                             }
+                             std::lock_guard<std::mutex> guard(connection->lock);
+                             session->game.makeMove(result.move);
+                             session->busy = false;
+                             reply = "bot " + std::to_string(id) + " " + std::to_string(result.move) + " " +
+                                     std::to_string(result.depth) + " " + std::to_string(threads);
+                         }
+                         catch (std::exception &e)
+                         {
+                             std::lock_guard<std::mutex> guard(connection->lock);
+                             session->busy = false;
+                             reply = "error " + std::to_string(id) + " " + e.what();
+                         }
+                         steady_clock::time_point done = steady_clock::now();
+                         microseconds elapsed = std::chrono::duration_cast<microseconds>(done - arrival);
+                         latency.record(elapsed);
+                         missed += done > deadline;
+                         if (reply.compare(0, 4, "bot ") == 0)
+                             reply += " " + std::to_string(elapsed.count());
+                         connection->stream.writeLine(reply); });
+    return "";
+}
+
+/*
+Writes the counters and the percentiles of both histograms.
+*/
+void GameServer::sendStats(Connection &connection)
+{
+    connection.stream.writeLine("stats sessions " + std::to_string(sessions) + " requests " +
+                                std::to_string(requests) + " missed " + std::to_string(missed) + " queued " +
+                                std::to_string(scheduler.getQueued()) + " running " +
+                                std::to_string(scheduler.getRunning()) + " threads " +
+                                std::to_string(scheduler.getBusyThreads()) + "/" +
+                                std::to_string(scheduler.getThreads()));
+    for (auto histogram : {std::make_pair("latency", &latency), std::make_pair("wait", &waiting)})
+    {
+        std::string line = std::string(histogram.first) + " count " + std::to_string(histogram.second->getCount()) +
+                           " mean " + std::to_string((long long)histogram.second->getMean());
+        for (double percent : SERVER_PERCENTILES)
+        {
+            std::ostringstream name;
+            name << " p" << percent << " ";
+            line += name.str() + std::to_string(histogram.second->percentile(percent).count());
+        }
+        line += " max " + std::to_string(histogram.second->getMax().count());
+        connection.stream.writeLine(line);
+    }
+    connection.stream.writeLine("end");
+}
+
+/*
+Writes the non-empty buckets of both histograms.
+*/
+void GameServer::sendHistogram(Connection &connection)
+{
+    for (unsigned int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        if (latency.getBucket(i) || waiting.getBucket(i))
+            connection.stream.writeLine(std::to_string(LatencyHistogram::bucketLimit(i)) + " " +
+                                        std::to_string(latency.getBucket(i)) + " " +
+                                        std::to_string(waiting.getBucket(i)));
+    connection.stream.writeLine("end");
+}
+
+int main(int argc, char const *argv[])
+{
+    std::string socketPath;
+    unsigned int threads = 0;
+    size_t megabytes = SERVER_TABLE_MB;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--socket")
+            socketPath = argv[++i];
+        else if (arg == "--stdio")
+            socketPath.clear();
+        else if (i + 1 < argc && arg == "--threads")
+            threads = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--table")
+            megabytes = atoll(argv[++i]);
+    }
+    signal(SIGPIPE, SIG_IGN); //clients that go away fail writes instead
+
+    GameServer server(threads, megabytes);
+    if (socketPath.empty())
+    {
+        server.serve(std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false));
+        server.wait();
+        return 0;
+    }
+    int listener;
+    try
+    {
+        listener = LineStream::listenUnix(socketPath);
+    }
+    catch (std::exception &e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    fprintf(stderr, "Listening on %s, %u search threads\n", socketPath.c_str(), server.getThreads());
+    while (true)
+    {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            fprintf(stderr, "accept failed\n");
+            return 1;
+        }
+        std::thread(&GameServer::serve, &server, std::make_shared<Connection>(client, client, true)).detach();
+    }
+}
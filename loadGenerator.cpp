@@ -0,0 +1,241 @@
+/*
+Load generator for gameServer: plays many games against the server at once
+and measures how long its bot moves take to come back.
+Each connection keeps its sessions busy: it plays random legal moves as
+player 1, asks for a bot move whenever player 2 is to move and starts a new
+game when one ends.  After the run it prints the client side latency
+percentiles and the server's own stats.
+
+Usage: loadGenerator socket [--connections n] [--sessions n] [--seconds s] [--time ms] [--seed n]
+--sessions is the games played at once on each connection (default 8, over 4 connections).
+--time is the reply time asked for each bot move (default 100ms).
+*/
+
+#include <iostream>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/LatencyHistogram.h"
+#include "src/LineStream.h"
+#include "src/Mancala.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+const unsigned int LOAD_CONNECTIONS = 4;
+const unsigned int LOAD_SESSIONS = 8; //per connection
+const unsigned int LOAD_SECONDS = 10;
+const milliseconds LOAD_BOT_TIME = milliseconds(100);
+const double LOAD_PERCENTILES[] = {50, 90, 99, 99.9};
+
+/*
+Totals over every connection.
+*/
+struct LoadStats
+{
+    LatencyHistogram latency; //bot move requests to replies
+    std::atomic<size_t> moves{0}, games{0}, late{0}, errors{0};
+};
+
+/*
+One game: the client's copy of the board, to choose legal moves from.
+*/
+struct Player
+{
+    unsigned int id = 0;
+    std::unique_ptr<DefaultMancala> game;
+    steady_clock::time_point sent; //when the bot move was asked for
+};
+
+/*
+Plays sessions games on one connection until stopTime, then waits for the
+replies still due and quits.
+*/
+void drive(const std::string &path, unsigned int sessions, milliseconds time, steady_clock::time_point stopTime,
+           uint64_t seed, LoadStats &stats)
+{
+    int socket;
+    try
+    {
+        socket = LineStream::connectUnix(path);
+    }
+    catch (std::exception &e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        stats.errors++;
+        return;
+    }
+    LineStream stream(socket, socket);
+    std::mt19937 random(seed);
+    std::vector<Player> players(sessions);
+    std::deque<size_t> opening; //players waiting for a session, in the order asked for
+    std::map<unsigned int, size_t> byId;
+    size_t due = 0; //session and bot replies still to come
+
+    auto start = [&](size_t index)
+    {
+        players[index].game.reset(new DefaultMancala());
+        opening.push_back(index);
+        due++;
+        stream.writeLine("new");
+    };
+    //Plays player index's moves until the bot is to move, then asks for it
+    auto play = [&](size_t index)
+    {
+        Player &player = players[index];
+        DefaultMancala &game = *player.game;
+        while (game.getWinner() < 0 && game.getTurn() == 1)
+        {
+            ActionList<action_t> moves;
+            game.getValidMoves(moves);
+            action_t pit = moves[random() % moves.size()];
+            game.makeMove(pit);
+            stream.writeLine("move " + std::to_string(player.id) + " " + std::to_string(pit));
+        }
+        bool over = game.getWinner() >= 0;
+        if (over || steady_clock::now() >= stopTime)
+        {
+            stats.games += over;
+            byId.erase(player.id);
+            stream.writeLine("close " + std::to_string(player.id));
+            if (steady_clock::now() < stopTime)
+                start(index);
+            return;
+        }
+        player.sent = steady_clock::now();
+        due++;
+        stream.writeLine("bot " + std::to_string(player.id) + " " + std::to_string(time.count()));
+    };
+
+    for (size_t i = 0; i < players.size(); i++)
+        start(i);
+    std::string line;
+    while (due > 0 && stream.readLine(line))
+    {
+        std::istringstream in(line);
+        std::string reply;
+        unsigned int id = 0;
+        in >> reply >> id;
+        if (reply == "session" && !opening.empty())
+        {
+            size_t index = opening.front();
+            opening.pop_front();
+            players[index].id = id;
+            byId[id] = index;
+            due--;
+            play(index);
+        }
+        else if (reply == "bot" && byId.count(id))
+        {
+            Player &player = players[byId[id]];
+            microseconds elapsed = std::chrono::duration_cast<microseconds>(steady_clock::now() - player.sent);
+            stats.latency.record(elapsed);
+            stats.late += elapsed > time;
+            stats.moves++;
+            due--;
+            action_t pit;
+            in >> pit;
+            try
+            {
+                player.game->makeMove(pit);
+            }
+            catch (std::invalid_argument &e)
+            {
+                fprintf(stderr, "session %u: bot played %u: %s\n", id, pit, e.what());
+                stats.errors++;
+                break;
+            }
+            play(byId[id]);
+        }
+        else if (reply == "error")
+        {
+            //The games are played in step with the server, so any error is a bug
+            fprintf(stderr, "%s\n", line.c_str());
+            stats.errors++;
+            break;
+        }
+    }
+    stream.writeLine("quit");
+}
+
+/*
+Prints the server's stats, from a connection of their own.
+*/
+void serverStats(const std::string &path)
+{
+    try
+    {
+        int socket = LineStream::connectUnix(path);
+        LineStream stream(socket, socket);
+        stream.writeLine("stats");
+        std::string line;
+        while (stream.readLine(line) && line != "end")
+            printf("  %s\n", line.c_str());
+        stream.writeLine("quit");
+    }
+    catch (std::exception &e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    std::string path;
+    unsigned int connections = LOAD_CONNECTIONS, sessions = LOAD_SESSIONS, seconds = LOAD_SECONDS;
+    milliseconds time = LOAD_BOT_TIME;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--connections")
+            connections = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--sessions")
+            sessions = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--seconds")
+            seconds = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--time")
+            time = milliseconds(atoi(argv[++i]));
+        else if (i + 1 < argc && arg == "--seed")
+            seed = atoll(argv[++i]);
+        else
+            path = arg;
+    }
+    if (path.empty())
+    {
+        printf("Usage: loadGenerator socket [--connections n] [--sessions n] [--seconds s] [--time ms] [--seed n]\n");
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("%u connections x %u games for %us, bot moves due in %ldms\n", connections, sessions, seconds,
+           (long)time.count());
+    LoadStats stats;
+    steady_clock::time_point startTime = steady_clock::now();
+    steady_clock::time_point stopTime = startTime + std::chrono::seconds(seconds);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < connections; i++)
+        threads.emplace_back(drive, path, sessions, time, stopTime, seed + i, std::ref(stats));
+    for (auto &thread : threads)
+        thread.join();
+    double elapsed = std::chrono::duration<double>(steady_clock::now() - startTime).count();
+
+    printf("Bot moves: %zu (%.1f/s), games finished: %zu, late: %zu, errors: %zu\n", stats.moves.load(),
+           stats.moves / elapsed, stats.games.load(), stats.late.load(), stats.errors.load());
+    printf("Client latency (us): mean %.0f", stats.latency.getMean());
+    for (double percent : LOAD_PERCENTILES)
+        printf(" p%g %lld", percent, (long long)stats.latency.percentile(percent).count());
+    printf(" max %lld\n", (long long)stats.latency.getMax().count());
+    printf("Server:\n");
+    serverStats(path);
+    return stats.errors > 0 ? 1 : 0;
+}
@@ -1,11 +1,13 @@
 /*
 Shows basic Mancala functionality.  Let's a human play against the computer in the console.
+The computer keeps thinking about the expected reply while the human chooses a pit.
+Usage: playMancala [tablebase]  (a file made by the tablebase program lets the computer play endgames perfectly)
 */
 
 #include <iostream>
 #include <random>
 #include "src/Mancala.h"
-#include "src/Bot.h"
+#include "src/SearchSession.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -15,31 +17,35 @@ using std::invalid_argument;
 using std::rand;
 using std::chrono::milliseconds;
 
-Mancala *myBoard;
-float utility1(Mancala *game, int position);
-bool maxLayerFunction(Mancala *game, int position);
+typedef ABSearchableState<DefaultMancala::board_t, action_t> state_type;
+
+DefaultMancala *myBoard;
+float utility1(DefaultMancala *game, int position);
+bool maxLayerFunction(DefaultMancala *game, int position);
 
 int main(int argc, char const *argv[])
 {
-    myBoard = new Mancala();
+    myBoard = new DefaultMancala();
+    if (argc > 1)
+        myBoard->setTablebase(std::make_shared<const MancalaTablebase>(argv[1]));
+    SearchSession<DefaultMancala::board_t, action_t> session([](state_type *game)
+                                                             { return utility1((DefaultMancala *)game, 2); },
+                                                             [](state_type *game)
+                                                             { return maxLayerFunction((DefaultMancala *)game, 2); },
+                                                             (unsigned int)5,
+                                                             (milliseconds)5000);
     int move;
     do
     {
         myBoard->print();
-        if (myBoard->getTurn() == 1)
+        bool aiMove = myBoard->getTurn() == 2;
+        if (!aiMove)
         {
             cout << "Select Pit: ";
             cin >> move;
         }
         else
-        {
-            move = myBoard->getAIMove([](auto *game)
-                                      { return utility1((Mancala *)game, 2); },
-                                      [](auto *game)
-                                      { return maxLayerFunction((Mancala *)game, 2); },
-                                      (unsigned int)5,
-                                      (milliseconds)5000);
-        }
+            move = session.getMove(myBoard);
         try
         {
             myBoard->makeMove(move);
@@ -48,12 +54,18 @@ int main(int argc, char const *argv[])
         {
             printf("%s\n", e.what());
         }
+        //Think on the human's time
+        if (aiMove && myBoard->getTurn() == 1 && myBoard->getWinner() < 0)
+            session.ponder(myBoard);
     } while (myBoard->getWinner() < 0);
+    session.stopPondering();
     myBoard->print();
+    printf("Expected replies: %zu of %zu\n", session.getPonderHits(),
+           session.getPonderHits() + session.getPonderMisses());
     delete myBoard;
 }
 
-float utility1(Mancala *game, int position)
+float utility1(DefaultMancala *game, int position)
 {
     float utility = (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
     utility += ((float)game->getState(game->getSize() - 2) + (float)game->getState(game->getSize() - 3) / 2) -
@@ -67,7 +79,7 @@ float utility1(Mancala *game, int position)
         return utility;
 }
 
-bool maxLayerFunction(Mancala *game, int position)
+bool maxLayerFunction(DefaultMancala *game, int position)
 {
     return game->getTurn() == position;
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+/*
+Solves small Mancala boards: the final store difference for the player to
+move with perfect play by both sides, for every first move.
+Usage: solve [pitsPerSide] [stones] [--table MB] [--checkpoint file] [--resume]
+             [--time seconds] [--progress seconds] [--tablebase file]
+--checkpoint saves progress to file every 10 minutes and when stopped;
+--resume continues from it (with the same --table size).
+--time stops after that long (and saves a checkpoint if asked for).
+--tablebase settles endgames from a file made by the tablebase program.
+*/
+
+#include <iostream>
+#include <string>
+#include "src/Mancala.h"
+#include "src/Solver.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+const size_t SOLVE_PITS = 4;
+const unsigned int SOLVE_STONES = 3;
+
+/*
+Store difference for player.
+*/
+template <class M>
+struct StoreDifference
+{
+    short player;
+    float operator()(M *game) const
+    {
+        float utility = (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
+        return player == 1 ? utility : -utility;
+    };
+};
+
+/*
+Maximizing layers are player's turns (players can move twice in a row).
+*/
+template <class M>
+struct PlayerLayers
+{
+    short player;
+    int color(M *game, int /*parentColor*/) const { return game->getTurn() == player ? 1 : -1; };
+};
+
+std::string bound(float value)
+{
+    if (value == FLT_MAX)
+        return "inf";
+    if (value == FLT_MAX * -1)
+        return "-inf";
+    return std::to_string((int)value);
+}
+
+void printProgress(const SolveProgress &progress)
+{
+    printf("%8.0fs  move %u/%u in [%s, %s]  %zu nodes (%.0f/s)  %zu proven (%.0f/s)  %u searches\n",
+           progress.seconds, progress.move + 1, progress.moves, bound(progress.lower).c_str(),
+           bound(progress.upper).c_str(), progress.nodes, progress.nodesPerSecond(), progress.proven,
+           progress.provenPerSecond(), progress.iterations);
+    fflush(stdout);
+}
+
+template <class M>
+int solve(size_t pitsPerSide, unsigned int stones, SolveOptions options, const std::string &tablebasePath)
+{
+    M game(pitsPerSide, stones);
+    if (!tablebasePath.empty())
+        game.setTablebase(std::make_shared<const MancalaTablebase>(tablebasePath));
+    short player = game.getTurn();
+    options.progress = printProgress;
+    Solver<M, StoreDifference<M>, PlayerLayers<M>> solver({player}, {player}, options);
+    printf("Solving %zu pits a side, %u stones a pit, %zuMB table\n", pitsPerSide, stones,
+           solver.getTable().getMemory() >> 20);
+    SolveResult<action_t> result = solver.solve(&game);
+
+    for (size_t i = 0; i < result.moves.size(); i++)
+        printf("pit %u: %+g\n", result.moves[i], result.values[i]);
+    if (!result.complete)
+    {
+        printf("Stopped after %zu of %u moves%s\n", result.moves.size(), result.progress.moves,
+               options.checkpointPath.empty() ? "" : ", continue with --resume");
+        return 2;
+    }
+    printf("Value %+g for player %d, best move pit %u (%zu nodes, %zu proven, %.1fs)\n", result.value, player,
+           result.move, result.progress.nodes, result.progress.proven, result.progress.seconds);
+    return 0;
+}
+
+int main(int argc, char const *argv[])
+{
+    size_t pitsPerSide = SOLVE_PITS;
+    unsigned int stones = SOLVE_STONES;
+    SolveOptions options;
+    std::string tablebasePath;
+    SearchControl control;
+    for (int i = 1, number = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--table")
+            options.megabytes = atoll(argv[++i]);
+        else if (i + 1 < argc && arg == "--checkpoint")
+            options.checkpointPath = argv[++i];
+        else if (arg == "--resume")
+            options.resume = true;
+        else if (i + 1 < argc && arg == "--time")
+        {
+            control.setDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(atoi(argv[++i])));
+            options.control = &control;
+        }
+        else if (i + 1 < argc && arg == "--progress")
+            options.progressInterval = std::chrono::seconds(atoi(argv[++i]));
+        else if (i + 1 < argc && arg == "--tablebase")
+            tablebasePath = argv[++i];
+        else if (number++ == 0)
+            pitsPerSide = atoi(argv[i]);
+        else
+            stones = atoi(argv[i]);
+    }
+
+    try
+    {
+        //Compile-time boards are faster
+        if (pitsPerSide == 4)
+            return solve<BasicMancala<4>>(pitsPerSide, stones, options, tablebasePath);
+        if (pitsPerSide == 5)
+            return solve<BasicMancala<5>>(pitsPerSide, stones, options, tablebasePath);
+        if (pitsPerSide == DEFAULT_SIZE)
+            return solve<DefaultMancala>(pitsPerSide, stones, options, tablebasePath);
+        return solve<Mancala>(pitsPerSide, stones, options, tablebasePath);
+    }
+    catch (std::exception &e)
+    {
+        printf("%s\n", e.what());
+        return 1;
+    }
+}
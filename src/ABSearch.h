@@ -2,20 +2,17 @@
 /*
 Class with static functions to perform alpha-beta pruning searches on
 ABSearchableState classes.
+Runs StaticSearch through the virtual ABSearchableState interface, with the
+utility and layer functions passed as function pointers.
 */
-#include <map>
+#include <atomic>
 #include <chrono>
-#include <cfloat>
-#include "Node.h"
-
-//Defaults
-const float DEFAULT_PRECISION = 0.001; //for checking float equality
-#ifndef DEBUG_LEVEL
-const int DEBUG_LEVEL = 0; //1 for some console printing
-#endif
+#include <vector>
+#include "ActionList.h"
+#include "StaticSearch.h"
 
 /*
-Custom exception for a timed out alpha-beta search.
+Custom exception for a timed out alpha-beta search that produced no move.
 */
 class ABTimeout : public std::exception
 {
@@ -27,6 +24,8 @@ class ABTimeout : public std::exception
 
 /*
 A state template object that is compatible with the ABSearch class.
+undoAction() must revert the most recent doAction() so the search can walk
+a single mutable state (make/unmake) instead of cloning every child.
 */
 template <class S, class A>
 class ABSearchableState
@@ -35,11 +34,80 @@ protected:
     S state;
 
 public:
-    virtual std::vector<A *> actions() = 0;
+    typedef A action_type;
+
+    virtual ~ABSearchableState(){};
+    virtual void generateActions(ActionList<A> &actions) = 0;
+    /*
+    Heap-allocated copies of generateActions().  Calling function is responsible for freeing.
+    */
+    virtual std::vector<A *> actions()
+    {
+        ActionList<A> list;
+        generateActions(list);
+        std::vector<A *> actions;
+        for (A &action : list)
+            actions.push_back(new A(action));
+        return actions;
+    };
     virtual ABSearchableState<S, A> *clone() = 0;
     virtual size_t hash() = 0;
     virtual void doAction(A action) = 0;
+    virtual void undoAction() = 0;
     virtual bool isABTerminalState() = 0;
+    /*
+    Optional move ordering hint: actions with higher values are searched
+    earlier (e.g. captures).  0 means nothing special.
+    */
+    virtual int actionHint(A /*action*/) { return 0; };
+    /*
+    Optional move identity for the history heuristic: a number below
+    MAX_ACTION_IDS that names the same move in every position it is played
+    from (e.g. the pit sown, or the from and to squares).
+    NO_ACTION_ID leaves the action out of the history table.
+    */
+    virtual unsigned int actionId(A /*action*/) { return NO_ACTION_ID; };
+    /*
+    Optional exact result: if the outcome of perfect play from here is known
+    (e.g. from an endgame tablebase), moves the state to the end of the game
+    it leads to and returns true; undoAction() reverts it.
+    */
+    virtual bool resolveExact() { return false; };
+    /*
+    Optional symmetry: hash of a canonical form shared by the state and its
+    mirror image (e.g. the same board with the players swapped).  Sets
+    mirrored if the canonical form is the mirror image, whose utility is
+    the negated utility of this state.  A mirror image must generate its
+    actions in the same order.  Only used by searches asked to (see
+    SearchOptions::symmetry).
+    */
+    virtual size_t canonicalHash(bool &mirrored)
+    {
+        mirrored = false;
+        return hash();
+    };
+};
+
+/*
+Evaluator and layer policy calling ABSearch's function pointers.
+*/
+template <class S, class A>
+struct UtilityPointer
+{
+    float (*function)(ABSearchableState<S, A> *);
+    float operator()(ABSearchableState<S, A> *state) const { return function(state); };
+};
+
+template <class S, class A>
+struct MaxLayerPointer
+{
+    bool (*function)(ABSearchableState<S, A> *); //nullptr alternates layers
+    int color(ABSearchableState<S, A> *state, int parentColor) const
+    {
+        if (function == nullptr)
+            return -parentColor;
+        return function(state) ? 1 : -1;
+    };
 };
 
 template <class S, class A>
@@ -51,19 +119,24 @@ public:
                     unsigned int maxDepth, std::chrono::milliseconds maxTime,
                     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now(),
                     float comparePrecision = DEFAULT_PRECISION,
-                    bool (*maxLayerCheck)(ABSearchableState<S, A> *) = nullptr);
+                    bool (*maxLayerCheck)(ABSearchableState<S, A> *) = nullptr,
+                    TranspositionTable *table = nullptr);
+    static SearchResult<A> SearchDepth(ABSearchableState<S, A> *rootState,
+                                       float (*utilityFunction)(ABSearchableState<S, A> *),
+                                       unsigned int maxDepth, std::chrono::milliseconds maxTime,
+                                       std::chrono::steady_clock::time_point startTime,
+                                       float comparePrecision,
+                                       bool (*maxLayerCheck)(ABSearchableState<S, A> *),
+                                       TranspositionTable *table,
+                                       const SearchResult<A> *previous = nullptr,
+                                       SearchControl *control = nullptr,
+                                       MoveOrdering<A> *ordering = nullptr,
+                                       const WindowOptions &windows = WindowOptions(),
+                                       bool collectStats = false,
+                                       bool symmetry = false);
 
 private:
-    static float minLayer(Node<ABSearchableState<S, A>, A> *node, float a, float b,
-                          float (*utilityFunction)(ABSearchableState<S, A> *),
-                          std::map<size_t, float> *visitedStates, unsigned int maxDepth,
-                          std::chrono::steady_clock::time_point startTime, std::chrono::milliseconds maxTime,
-                          bool (*maxLayerCheck)(ABSearchableState<S, A> *));
-    static float maxLayer(Node<ABSearchableState<S, A>, A> *node, float a, float b,
-                          float (*utilityFunction)(ABSearchableState<S, A> *),
-                          std::map<size_t, float> *visitedStates, unsigned int maxDepth,
-                          std::chrono::steady_clock::time_point startTime, std::chrono::milliseconds maxTime,
-                          bool (*maxLayerCheck)(ABSearchableState<S, A> *));
+    typedef StaticSearch<ABSearchableState<S, A>, UtilityPointer<S, A>, MaxLayerPointer<S, A>> Core;
 };
 
 #include "ABSearch.tpp"
\ No newline at end of file
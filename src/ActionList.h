@@ -0,0 +1,40 @@
+#pragma once
+/*
+Fixed-capacity list of actions filled in place by move generators.
+Lives on the caller's stack, so generating moves never touches the heap.
+*/
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+
+//Defaults
+const size_t MAX_ACTIONS = 64; //most actions any state may generate
+const unsigned int MAX_ACTION_IDS = 1024; //ids from ABSearchableState::actionId() are below this
+const unsigned int NO_ACTION_ID = UINT_MAX; //action has no id
+
+template <class A, size_t Capacity = MAX_ACTIONS>
+class ActionList
+{
+private:
+    A list[Capacity];
+    size_t count = 0;
+
+public:
+    void push_back(A action)
+    {
+        if (count == Capacity)
+            throw std::length_error("too many actions for ActionList");
+        list[count++] = action;
+    };
+    void clear() { count = 0; };
+
+    //getters
+    size_t size() const { return count; };
+    bool empty() const { return count == 0; };
+    A &operator[](size_t i) { return list[i]; };
+    const A &operator[](size_t i) const { return list[i]; };
+    A *begin() { return list; };
+    A *end() { return list + count; };
+    const A *begin() const { return list; };
+    const A *end() const { return list + count; };
+};
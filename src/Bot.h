@@ -3,26 +3,60 @@
 Wrapper class for calling multithreaded, iterative deepening alpha-beta searches.
 */
 #include <thread>
-#include <future>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <pthread.h>
 #include "ABSearch.h"
+#include "ThreadPool.h"
 
 //Defaults
-const unsigned int DEFAULT_DEPTH = 10;
+const unsigned int DEFAULT_DEPTH = 1; //First iterative deepening depth
 const unsigned int MAX_DEPTH = 50; //Will never search deeper than this
 const std::chrono::milliseconds DEFAULT_TIME =
     std::chrono::milliseconds(10); //Max time spent searching
 
+/*
+Optional search settings.
+*/
+struct SearchOptions
+{
+    unsigned int threads = 0;          //search threads (0 = hardware_concurrency())
+    unsigned int maxDepth = MAX_DEPTH; //stop once an iteration of this depth completes
+    ThreadPool *pool = nullptr;        //where helper threads come from (nullptr = ThreadPool::shared());
+                                       //helpers still queued when the search stops never start, so a busy
+                                       //pool costs helpers but not the deadline (SearchSession owns one)
+    unsigned int checkInterval = DEFAULT_CHECK_INTERVAL; //nodes searched between stop checks
+    size_t maxNodes = 0;               //stop after about this many nodes on all threads (0 = no limit)
+    OrderingOptions ordering;          //move ordering heuristics
+    WindowOptions windows;             //PVS and aspiration windows
+    bool stats = false;                //collect SearchResult::stats
+    bool symmetry = false;             //share table entries between mirror images (ABSearchableState::canonicalHash());
+                                       //needs a utility function that is negated by the mirror
+    SearchControl *control = nullptr;  //stop through this control instead, with no thinkTime deadline
+                                       //(set one on it to end the search, e.g. when pondering)
+};
+
 template <class S, class A>
 class Bot
 {
 public:
+    static SearchResult<A> search(ABSearchableState<S, A> *state,
+                                  float (*utilityFunction)(ABSearchableState<S, A> *),
+                                  unsigned int searchDepth = DEFAULT_DEPTH,
+                                  std::chrono::milliseconds thinkTime = DEFAULT_TIME,
+                                  float comparePrecision = DEFAULT_PRECISION,
+                                  bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                                  TranspositionTable *table = nullptr,
+                                  const SearchOptions &options = SearchOptions());
     static A getMove(ABSearchableState<S, A> *state,
                      float (*utilityFunction)(ABSearchableState<S, A> *),
                      unsigned int searchDepth = DEFAULT_DEPTH,
                      std::chrono::milliseconds thinkTime = DEFAULT_TIME,
                      float comparePrecision = DEFAULT_PRECISION,
-                     bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr);
+                     bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                     TranspositionTable *table = nullptr,
+                     const SearchOptions &options = SearchOptions());
 };
 
 #include "Bot.tpp"
\ No newline at end of file
@@ -2,63 +2,131 @@
 #include "Bot.h"
 
 /*
-Manages threads and futures.  Calls ABSearch::Search.
+Iterative deepening driver.  Searches depth searchDepth, searchDepth + 1, ...
+until thinkTime runs out or options.maxDepth is reached.  Each iteration
+searches the previous one's principal variation first, in an aspiration window
+around its value, and reuses its table entries for move ordering, so deeper
+iterations prune far more than a cold search.
+
+Lazy SMP: every thread runs its own iterative deepening on the root, half of
+them one depth ahead, all sharing table.  Threads fill the table for each
+other, so together they reach a depth sooner than one thread alone.
+The calling thread is the main search thread; helpers run as tasks on a
+persistent thread pool and stop as soon as the main thread does.
+Searches stop through a shared SearchControl, set when thinkTime runs out or
+options.maxNodes have been searched.  With options.control, that control is
+used without a deadline, so the search runs until it is stopped or given one.
+Returns the result of the deepest iteration (result.depth); an iteration cut
+off by the deadline counts if it finished at least one root move, and since
+it searches the previous best move first, its move is never worse informed.
+result.nodes counts the nodes of every iteration on every thread, and so does
+result.stats if options.stats is set.  result.iterations lists the main
+thread's iterations and result.seconds is the wall time of the whole search.
+All iterations share table, so it can be passed in again for the next move.
+If table is nullptr, a table is allocated for this call only.
 */
 template <class S, class A>
-A Bot<S, A>::getMove(ABSearchableState<S, A> *state, float (*utilityFunction)(ABSearchableState<S, A> *),
-                     unsigned int searchDepth, std::chrono::milliseconds thinkTime, float comparePrecision,
-                     bool (*maxLayerFunction)(ABSearchableState<S, A> *))
+SearchResult<A> Bot<S, A>::search(ABSearchableState<S, A> *state, float (*utilityFunction)(ABSearchableState<S, A> *),
+                                  unsigned int searchDepth, std::chrono::milliseconds thinkTime, float comparePrecision,
+                                  bool (*maxLayerFunction)(ABSearchableState<S, A> *),
+                                  TranspositionTable *table, const SearchOptions &options)
 {
-    size_t maxThreads = std::thread::hardware_concurrency(); //get hardware capability
-    std::vector<std::future<A>> futures;
-    std::vector<A> results;
+    std::unique_ptr<TranspositionTable> localTable;
+    if (table == nullptr)
+    {
+        localTable.reset(new TranspositionTable());
+        table = localTable.get();
+    }
+    table->newSearch(); //age entries from earlier moves
     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now(); //Get current time
+    size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency(); //get hardware capability
+    unsigned int maxDepth = std::min(options.maxDepth, MAX_DEPTH);
 
-    //While we haven't reached max depth and we're within our time limit
-    while (searchDepth <= MAX_DEPTH && startTime + thinkTime >= std::chrono::steady_clock::now())
+    SearchControl localControl(options.checkInterval);
+    SearchControl &control = options.control ? *options.control : localControl;
+    if (!options.control)
+        control.setDeadline(startTime + thinkTime);
+    control.setNodeLimit(options.maxNodes);
+    std::mutex resultLock;
+    SearchResult<A> best;
+    std::exception_ptr error;
+    size_t nodes = 0;
+    SearchStats stats;
+    std::vector<IterationStats> iterations;
+    auto iterate = [&](unsigned int thread)
     {
-        //Get a count of all active (not finished/ready) threads
-        int f = 0;
-        for (auto &future : futures)
+        SearchResult<A> result;
+        MoveOrdering<A> ordering(options.ordering);
+        //While we haven't reached max depth and we're within our time limit
+        for (unsigned int depth = std::max(searchDepth, 1u) + thread % 2;
+             depth <= maxDepth && !control.stopped(); depth++)
         {
-            //Take 500 ms to check the futures vector instead of explicitly waiting/sleeping
-            if (future.wait_for(std::chrono::milliseconds(500 / futures.size())) == std::future_status::timeout)
+            try
+            {
+                result = ABSearch<S, A>::SearchDepth(state, utilityFunction, depth, thinkTime, startTime,
+                                                     comparePrecision, maxLayerFunction, table, &result, &control,
+                                                     &ordering, options.windows, options.stats,
+                                                     options.symmetry);
+            }
+            catch (...)
             {
-                f++;
+                std::lock_guard<std::mutex> guard(resultLock);
+                error = std::current_exception();
+                control.stop();
+                break;
             }
+            std::lock_guard<std::mutex> guard(resultLock);
+            nodes += result.nodes;
+            stats += result.stats;
+            if (thread == 0)
+                iterations.push_back({depth, result.value, result.depth > 0 && result.complete,
+                                      result.nodes, result.seconds});
+            //Stopped before finishing a single root move
+            if (result.depth == 0)
+                break;
+            if (result.depth > best.depth || (result.depth == best.depth && result.complete && !best.complete))
+                best = result;
+            if (best.depth >= maxDepth && best.complete)
+                control.stop();
+            //Out of time, or another thread finished
+            if (!result.complete)
+                break;
         }
+    };
 
-        //Create new threads upto max
-        for (int i = 0; i < maxThreads - f; i++)
-        {
-            futures.push_back(std::async(&ABSearch<S, A>::Search, state, utilityFunction,
-                                         searchDepth, thinkTime, startTime, comparePrecision,
-                                         maxLayerFunction));
-            searchDepth++;
-        }
-    }
+    ThreadPool &pool = options.pool ? *options.pool : ThreadPool::shared();
+    TaskGroup helpers;
+    for (unsigned int i = 1; i < threads; i++)
+        helpers.run(pool, [&iterate, i]
+                    { iterate(i); });
+    iterate(0);
+    control.stop(); //main thread is done, so are the helpers
+    helpers.wait();
 
-    //Retrieve our results
-    for (auto &future : futures)
-    {
-        try
-        {
-            results.push_back(future.get());
-        }
-        //If exception, ignore it and keep checking results
-        catch (...)
-        {
-            continue;
-        }
-    }
-    //Try to return the last element of results (deepest completed depth)
-    try
-    {
-        return results.back();
-    }
-    //If no search complete, they probably timed out.
-    catch (...)
-    {
+    if (error)
+        std::rethrow_exception(error);
+    //If no search complete, it timed out.
+    if (best.depth == 0)
         throw ABTimeout();
-    }
-}
\ No newline at end of file
+    best.nodes = nodes;
+    best.stats = stats;
+    best.iterations = iterations;
+    best.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (DEBUG_LEVEL)
+        printf("Completed depth: %d\n", best.depth);
+    return best;
+}
+
+/*
+Returns the best move found by search().
+*/
+template <class S, class A>
+A Bot<S, A>::getMove(ABSearchableState<S, A> *state, float (*utilityFunction)(ABSearchableState<S, A> *),
+                     unsigned int searchDepth, std::chrono::milliseconds thinkTime, float comparePrecision,
+                     bool (*maxLayerFunction)(ABSearchableState<S, A> *),
+                     TranspositionTable *table, const SearchOptions &options)
+{
+    return search(state, utilityFunction, searchDepth, thinkTime, comparePrecision,
+                  maxLayerFunction, table, options)
+        .move;
+}
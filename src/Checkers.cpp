@@ -0,0 +1,327 @@
+#pragma once
+#include "Checkers.h"
+
+/*
+Constructor
+Sets up the starting position: player 1's men on squares 1-12, player 2's on 21-32.
+*/
+Checkers::Checkers()
+{
+    CheckersBoard board;
+    board.pieces[0] = 0x00000FFF;
+    board.pieces[1] = 0xFFF00000;
+    initialize(board);
+}
+
+/*
+Constructor
+Sets up a position with turn to move.  A player left without a move has lost.
+Throws invalid_argument if the players' pieces overlap, kings are not on a
+piece or turn is not 1 or 2.
+*/
+Checkers::Checkers(const CheckersBoard &board, short turn)
+{
+    if (board.pieces[0] & board.pieces[1])
+        throw std::invalid_argument("players' pieces overlap");
+    if (board.kings & ~(board.pieces[0] | board.pieces[1]))
+        throw std::invalid_argument("kings must be on a piece");
+    if (turn != 1 && turn != 2)
+        throw std::invalid_argument("turn must be 1 or 2");
+    initialize(board);
+    this->turn = turn;
+    if (!hasMoves())
+        winner = turn % 2 + 1;
+}
+
+/*
+Initializes member state and variables.
+*/
+void Checkers::initialize(const CheckersBoard &board)
+{
+    state = board;
+    zobrist = Zobrist::shared(CHECKERS_SQUARES, 5);
+    boardHash = 0;
+    for (unsigned int square = 0; square < CHECKERS_SQUARES; square++)
+        boardHash ^= zobrist->key(square, squareValue(square));
+}
+
+/*
+Fills moves with every legal move of the player to move: the capturing
+sequences if there are any, otherwise the plain moves.  Sequences that jump
+the same pieces from and to the same squares are only listed once.
+*/
+void Checkers::getValidMoves(ActionList<CheckersMove> &moves)
+{
+    int mover = turn - 1;
+    uint32_t own = state.pieces[mover], empty = ~(state.pieces[0] | state.pieces[1]);
+    uint32_t capturing = jumpers();
+    if (capturing)
+    {
+        for (; capturing; capturing &= capturing - 1)
+        {
+            unsigned int square = __builtin_ctz(capturing);
+            addJumps(moves, square, square, state.kings >> square & 1, 0, empty | 1u << square);
+        }
+        return;
+    }
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+        //Men only step forward
+        uint32_t movers = direction - firstDirection(turn) < 2 ? own : own & state.kings;
+        for (uint32_t targets = step(movers, direction) & empty; targets; targets &= targets - 1)
+        {
+            unsigned int to = __builtin_ctz(targets);
+            moves.push_back({(uint8_t)__builtin_ctz(step(1u << to, 3 - direction)), (uint8_t)to, 0});
+        }
+    }
+}
+
+/*
+Pieces of the player to move that can capture.
+*/
+uint32_t Checkers::jumpers()
+{
+    int mover = turn - 1;
+    uint32_t own = state.pieces[mover], opponent = state.pieces[1 - mover];
+    uint32_t empty = ~(state.pieces[0] | state.pieces[1]);
+    uint32_t capturing = 0;
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+        uint32_t movers = direction - firstDirection(turn) < 2 ? own : own & state.kings;
+        //Pieces with an opponent in direction and an empty square behind it
+        capturing |= movers & step(step(empty, 3 - direction) & opponent, 3 - direction);
+    }
+    return capturing;
+}
+
+/*
+Adds the capturing sequences of the piece that started on from and has reached
+square, having jumped captures so far.  empty includes from, which the piece left.
+*/
+void Checkers::addJumps(ActionList<CheckersMove> &moves, unsigned int from, unsigned int square, bool king,
+                        uint32_t captures, uint32_t empty)
+{
+    uint32_t opponent = state.pieces[2 - turn] & ~captures; //a piece is only jumped once
+    bool extended = false;
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+        if (!king && direction - firstDirection(turn) >= 2)
+            continue;
+        uint32_t jumped = step(1u << square, direction) & opponent;
+        uint32_t landing = step(jumped, direction) & empty;
+        if (!landing)
+            continue;
+        extended = true;
+        unsigned int to = __builtin_ctz(landing);
+        if (!king && (landing & crowningRow(turn)))
+            moves.push_back({(uint8_t)from, (uint8_t)to, captures | jumped}); //crowning ends the move
+        else
+            addJumps(moves, from, to, king, captures | jumped, empty);
+    }
+    if (extended || captures == 0)
+        return;
+    //Kings can reach the same end by jumping the same pieces in another order
+    CheckersMove move = {(uint8_t)from, (uint8_t)square, captures};
+    if (king)
+        for (auto &other : moves)
+            if (other == move)
+                return;
+    moves.push_back(move);
+}
+
+/*
+Pieces of the player to move that have a legal move.
+*/
+uint32_t Checkers::movablePieces()
+{
+    uint32_t capturing = jumpers();
+    if (capturing)
+        return capturing;
+    uint32_t own = state.pieces[turn - 1], empty = ~(state.pieces[0] | state.pieces[1]);
+    uint32_t movable = 0;
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+        uint32_t movers = direction - firstDirection(turn) < 2 ? own : own & state.kings;
+        movable |= movers & step(empty, 3 - direction);
+    }
+    return movable;
+}
+
+/*
+Move ordering hint: pieces captured, plus one for crowning a man.
+*/
+int Checkers::actionHint(CheckersMove move)
+{
+    bool crowns = !(state.kings >> move.from & 1) && (crowningRow(turn) >> move.to & 1);
+    return __builtin_popcount(move.captures) + crowns;
+}
+
+/*
+Public function to make move.  Checks for valid move, then calls private makeValidMove().
+Throws invalid_argument exception if move is invalid.
+*/
+void Checkers::makeMove(CheckersMove move)
+{
+    if (winner >= 0)
+    {
+        //Keep makeMove()/undoMove() paired even when nothing happens
+        history.push_back({move, false, false, 0, turn, winner, gameStarted, boardHash, quietPlies});
+        return;
+    }
+    if (isValidMove(move))
+        makeValidMove(move);
+    else
+        throw std::invalid_argument("invalid move");
+}
+
+/*
+Makes a move taken from getValidMoves() without checking it.
+*/
+void Checkers::doAction(CheckersMove move)
+{
+    if (winner >= 0)
+        makeMove(move);
+    else
+        makeValidMove(move);
+    gameStarted = true;
+}
+
+/*
+Makes a valid move and sets up the next player's turn.
+Records what is needed to revert it in history.
+*/
+void Checkers::makeValidMove(const CheckersMove &move)
+{
+    int mover = turn - 1;
+    uint32_t from = 1u << move.from, to = 1u << move.to;
+    bool king = state.kings & from;
+    CheckersUndo undo = {move, true, false, state.kings & move.captures, turn, winner, gameStarted, boardHash,
+                         quietPlies};
+
+    zobrist->update(boardHash, move.from, squareValue(move.from), 0);
+    state.pieces[mover] ^= from | to;
+    if (king)
+        state.kings ^= from | to;
+    else if (to & crowningRow(turn))
+    {
+        state.kings |= to;
+        undo.crowned = true;
+    }
+    zobrist->update(boardHash, move.to, 0, squareValue(move.to));
+    for (uint32_t captured = move.captures; captured; captured &= captured - 1)
+    {
+        unsigned int square = __builtin_ctz(captured);
+        zobrist->update(boardHash, square, squareValue(square), 0);
+    }
+    state.pieces[1 - mover] &= ~move.captures;
+    state.kings &= ~move.captures;
+    quietPlies = move.captures || !king ? 0 : quietPlies + 1;
+    history.push_back(undo);
+
+    changeTurn();
+    if (!hasMoves())
+        winner = mover + 1;
+    else if (quietPlies >= CHECKERS_DRAW_PLIES)
+        winner = 0;
+}
+
+/*
+Reverts the last move made with makeMove().
+Throws logic_error if there is no move to revert.
+*/
+void Checkers::undoMove()
+{
+    if (history.empty())
+        throw std::logic_error("no move to undo");
+    CheckersUndo undo = history.back();
+    history.pop_back();
+    turn = undo.turn;
+    winner = undo.winner;
+    gameStarted = undo.gameStarted;
+    boardHash = undo.boardHash;
+    quietPlies = undo.quietPlies;
+    if (!undo.played)
+        return;
+    int mover = turn - 1;
+    uint32_t from = 1u << undo.move.from, to = 1u << undo.move.to;
+    state.pieces[mover] ^= from | to;
+    if (undo.crowned)
+        state.kings &= ~to;
+    else if (state.kings & to)
+        state.kings ^= from | to;
+    state.pieces[1 - mover] |= undo.move.captures;
+    state.kings |= undo.capturedKings;
+}
+
+/*
+Returns a numeric hash of the game state based on
+the pieces and current player turn.
+The board part is maintained incrementally by moves, so this is O(1).
+*/
+size_t Checkers::hash()
+{
+    return boardHash ^ zobrist->sideKey(turn);
+}
+
+/*
+Returns a pointer to a clone of the game, with its own search memory like
+Mancala's clones.  Calling function is responsible for freeing.
+*/
+Checkers *Checkers::clone()
+{
+    Checkers *newCheckers = new Checkers(*this);
+    newCheckers->history.clear();
+    newCheckers->table.reset();
+    return newCheckers;
+}
+
+unsigned int Checkers::squareValue(unsigned int square)
+{
+    uint32_t bit = 1u << square;
+    unsigned int king = (state.kings & bit) ? 1 : 0;
+    if (state.pieces[0] & bit)
+        return 1 + king;
+    if (state.pieces[1] & bit)
+        return 3 + king;
+    return 0;
+}
+
+/*
+Standard notation number (1-32) of an internal square.
+*/
+unsigned int Checkers::squareNumber(unsigned int square)
+{
+    return square / 4 * 4 + 3 - square % 4 + 1;
+}
+
+/*
+Move in standard notation: "from-to", or "fromxto" for a capture.
+*/
+std::string Checkers::moveString(const CheckersMove &move)
+{
+    return std::to_string(squareNumber(move.from)) + (move.captures ? "x" : "-") +
+           std::to_string(squareNumber(move.to));
+}
+
+/*
+Print the board to console, player 1's side at the top.
+Men are b (player 1) and w (player 2), kings B and W.
+*/
+void Checkers::print()
+{
+    for (int row = 0; row < 8; row++)
+    {
+        for (int column = 7; column >= 0; column--)
+        {
+            if ((row + column) % 2 != 0)
+            {
+                std::cout << "  ";
+                continue;
+            }
+            unsigned int value = squareValue(row * 4 + column / 2);
+            std::cout << ' ' << ".bBwW"[value];
+        }
+        std::cout << "\n";
+    }
+    printf("Player %d's turn\n", turn); //turn
+}
@@ -0,0 +1,159 @@
+#pragma once
+/*
+English draughts (American checkers) on an 8x8 board.
+
+RULES
+1. Pieces only stand on the 32 dark squares.  Player 1 (Black) starts on squares 1-12 and moves first,
+   player 2 (White) starts on squares 21-32.
+2. Men move one square diagonally forward.  Kings move one square diagonally in any direction.
+3. A piece jumps over a diagonally adjacent opposing piece onto the empty square behind it, capturing it.
+   Men only jump forward.  After a jump, the same piece must keep jumping while it can.
+4. Capturing is compulsory, but any capturing sequence may be chosen (not necessarily the longest).
+5. A man reaching the far row is crowned king.  Being crowned ends the move.
+6. A player who cannot move (no pieces, or all blocked) loses.
+7. The game is drawn after CHECKERS_DRAW_PLIES moves in a row without a capture or a man moving.
+
+BOARD LAYOUT W/ SQUARE #'s (standard notation, seen from player 1's side)
+    32 31 30 29        player 2
+  28 27 26 25
+    24 23 22 21
+  20 19 18 17
+    16 15 14 13
+  12 11 10  9
+     8  7  6  5
+   4  3  2  1          player 1
+print() shows the board turned around, player 1's side at the top, as in published diagrams.
+
+BITBOARDS
+Internally square s (0-31) is bit s: row s / 4 counted from player 1's back row, and
+column 2 * (s % 4) on even rows, 2 * (s % 4) + 1 on odd rows.  A diagonal step is
+then a shift by 3, 4 or 5 depending on the row, so move generation works on
+whole sides at once with shifts and masks.
+*/
+
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include "Game.h"
+#include "Zobrist.h"
+
+/*
+Position: which squares each player's pieces are on and which pieces are kings.
+*/
+struct CheckersBoard
+{
+    uint32_t pieces[2] = {0, 0}; //player 1's and player 2's pieces, men and kings
+    uint32_t kings = 0;          //kings of both players
+};
+
+/*
+A move or a whole capturing sequence.
+*/
+struct CheckersMove
+{
+    uint8_t from = 0, to = 0; //internal squares (0-31)
+    uint32_t captures = 0;    //squares of the jumped pieces (0 for a plain move)
+
+    bool operator==(const CheckersMove &other) const
+    {
+        return from == other.from && to == other.to && captures == other.captures;
+    };
+    bool operator!=(const CheckersMove &other) const { return !(*this == other); };
+};
+
+/*
+Everything needed to revert one move in place.
+*/
+struct CheckersUndo
+{
+    CheckersMove move;
+    bool played;            //false if the game was already over and nothing moved
+    bool crowned;           //the moving man became a king
+    uint32_t capturedKings; //kings among move.captures
+    short turn, winner;
+    bool gameStarted;
+    uint64_t boardHash;
+    unsigned int quietPlies;
+};
+
+//Defaults
+const unsigned int CHECKERS_SQUARES = 32;
+const unsigned int CHECKERS_DRAW_PLIES = 80; //40 moves each without a capture or a man moving
+
+class Checkers final : public Game<CheckersBoard, CheckersMove>
+{
+public:
+    typedef CheckersBoard board_t;
+
+    //construct/destruct
+    Checkers();
+    Checkers(const CheckersBoard &board, short turn = 1);
+    ~Checkers(){};
+
+    //overrides
+    void makeMove(CheckersMove move) override;
+    void doAction(CheckersMove move) override; //trusts the search to pass a generated move
+    void undoMove() override;
+    void getValidMoves(ActionList<CheckersMove> &moves) override;
+    using Game<CheckersBoard, CheckersMove>::getValidMoves;
+    bool isABTerminalState() override { return winner >= 0; };
+    int actionHint(CheckersMove move) override;
+    unsigned int actionId(CheckersMove move) override { return move.from * 32 + move.to; };
+    size_t hash() override;
+    Checkers *clone() override;
+
+    //getters
+    const CheckersBoard &getBoard() { return state; };
+    int getPieceCount(int player) { return __builtin_popcount(state.pieces[(player - 1) & 1]); };
+    int getKingCount(int player) { return __builtin_popcount(state.pieces[(player - 1) & 1] & state.kings); };
+    unsigned int getQuietPlies() { return quietPlies; };
+    uint32_t movablePieces(); //pieces of the player to move that have a legal move
+
+    //helpers
+    void print();
+    static unsigned int squareNumber(unsigned int square); //internal square to standard notation
+    static std::string moveString(const CheckersMove &move); //e.g. "11-15" or "15x24"
+
+private:
+    //member variables
+    std::vector<CheckersUndo> history; //one record per move, for undoMove()
+    std::shared_ptr<const Zobrist> zobrist;
+    uint64_t boardHash; //Zobrist hash of the squares, kept up to date by every move
+    unsigned int quietPlies = 0; //moves since the last capture or man move
+
+    void initialize(const CheckersBoard &board);
+    void makeValidMove(const CheckersMove &move);
+    void changeTurn() { turn = (turn % 2) + 1; };
+    bool hasMoves() { return movablePieces() != 0; };
+    uint32_t jumpers();
+    void addJumps(ActionList<CheckersMove> &moves, unsigned int from, unsigned int square, bool king,
+                  uint32_t captures, uint32_t empty);
+    unsigned int squareValue(unsigned int square); //Zobrist value: 0 empty, 1-2 player 1 man/king, 3-4 player 2
+
+    /*
+    Diagonal steps of every square in squares: 0 up-left, 1 up-right, 2 down-left,
+    3 down-right ("up" is towards player 2).  3 - direction is the opposite step.
+    Steps off the board are dropped.
+    */
+    static uint32_t step(uint32_t squares, unsigned int direction)
+    {
+        const uint32_t even = 0x0F0F0F0F, odd = 0xF0F0F0F0; //rows
+        const uint32_t evenNotLeft = 0x0E0E0E0E, oddNotRight = 0x70707070;
+        switch (direction)
+        {
+        case 0:
+            return ((squares & evenNotLeft) << 3) | ((squares & odd) << 4);
+        case 1:
+            return ((squares & even) << 4) | ((squares & oddNotRight) << 5);
+        case 2:
+            return ((squares & evenNotLeft) >> 5) | ((squares & odd) >> 4);
+        default:
+            return ((squares & even) >> 4) | ((squares & oddNotRight) >> 3);
+        }
+    };
+    //Directions player's men move in: forward only
+    static unsigned int firstDirection(int player) { return player == 1 ? 0 : 2; };
+    static uint32_t crowningRow(int player) { return player == 1 ? 0xF0000000 : 0x0000000F; };
+};
+
+#include "Checkers.cpp"
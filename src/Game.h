@@ -5,8 +5,10 @@ Provides framework for adversarial games that are alpha-beta prune friendly.
 (Eg., chess, checkers)
 */
 
+#include <memory>
 #include "ABSearch.h"
 #include "Bot.h"
+#include "MCTS.h"
 
 template <class S, class A>
 class Game : public ABSearchableState<S, A>
@@ -15,38 +17,59 @@ protected:
     //member variables
     short winner = -1, turn = 1;
     bool gameStarted = false;
+    //search memory of this game object, kept across its getAIMove() calls (clone() does not share it)
+    std::shared_ptr<TranspositionTable> table;
+    size_t searchMemory = DEFAULT_TABLE_MB;
+    SearchOptions searchOptions; //used by getAIMove()
+    MCTSOptions mctsOptions;     //used by getMCTSMove()
+    float (*lastUtilityFunction)(ABSearchableState<S, A> *) = nullptr;
 
-    bool isValidMove(A move);
+    virtual bool isValidMove(A move);
+    TranspositionTable *getTable(float (*utilityFunction)(ABSearchableState<S, A> *));
 
 public:
     //overrides
     void doAction(A action) override
     {
-        gameStarted = true;
         makeMove(action);
+        gameStarted = true;
     };
+    void undoAction() override { undoMove(); };
     virtual Game<S, A> *clone() override = 0;
-    std::vector<A *> actions() override { return getValidMoves(); };
+    void generateActions(ActionList<A> &actions) override { getValidMoves(actions); };
 
     //AI wrappers
     A getAIMove(float (*utilityFunction)(ABSearchableState<S, A> *))
     {
-        return Bot<S, A>::getMove(this, utilityFunction);
+        return Bot<S, A>::getMove(this, utilityFunction, DEFAULT_DEPTH, DEFAULT_TIME,
+                                  DEFAULT_PRECISION, nullptr, getTable(utilityFunction), searchOptions);
     };
     A getAIMove(float (*utilityFunction)(ABSearchableState<S, A> *),
                 bool (*maxLayerFunction)(ABSearchableState<S, A> *),
                 unsigned int searchDepth, std::chrono::milliseconds thinkTime)
     {
-        return Bot<S, A>::getMove(this, utilityFunction, searchDepth, thinkTime, DEFAULT_PRECISION, maxLayerFunction);
+        return Bot<S, A>::getMove(this, utilityFunction, searchDepth, thinkTime, DEFAULT_PRECISION,
+                                  maxLayerFunction, getTable(utilityFunction), searchOptions);
+    };
+    A getMCTSMove(float (*utilityFunction)(ABSearchableState<S, A> *),
+                  bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                  std::chrono::milliseconds thinkTime = DEFAULT_TIME)
+    {
+        return MCTS<S, A>::getMove(this, utilityFunction, thinkTime, maxLayerFunction, nullptr, mctsOptions);
     };
+    void setSearchMemory(size_t megabytes);
+    void setSearchOptions(const SearchOptions &options) { searchOptions = options; };
+    void setMCTSOptions(const MCTSOptions &options) { mctsOptions = options; };
 
     //getters/setters
-    virtual std::vector<A *> getValidMoves() = 0;
+    virtual void getValidMoves(ActionList<A> &moves) = 0;
+    std::vector<A *> getValidMoves() { return this->actions(); }; //Calling function is responsible for freeing
     int getTurn() { return turn; };
     int getWinner() { return winner; };
     void setTurn(int turn);
 
     virtual void makeMove(A move) = 0;
+    virtual void undoMove() = 0; //reverts the last makeMove()
 };
 
 #include "Game.tpp"
\ No newline at end of file
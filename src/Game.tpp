@@ -2,20 +2,18 @@
 #include "Game.h"
 
 /*
-Retrieves vector of valid moves and checks if passed in move exists in vector.
+Generates valid moves and checks if passed in move is one of them.
+Games that can check a move directly should override this.
 */
 template <class S, class A>
 bool Game<S, A>::isValidMove(A thisMove)
 {
-    std::vector<A *> validMoves = getValidMoves();
-    bool validMove = false;
-    for (A *move : validMoves)
-    {
-        if (*move == thisMove)
-            validMove = true;
-        delete move;
-    }
-    return validMove;
+    ActionList<A> validMoves;
+    getValidMoves(validMoves);
+    for (A &move : validMoves)
+        if (move == thisMove)
+            return true;
+    return false;
 }
 
 /*
@@ -30,4 +28,30 @@ void Game<S, A>::setTurn(int turn)
             this->turn = 1;
         else
             this->turn = 2;
+}
+
+/*
+Sets the transposition table size used by getAIMove().
+*/
+template <class S, class A>
+void Game<S, A>::setSearchMemory(size_t megabytes)
+{
+    searchMemory = megabytes;
+    if (table)
+        table->resize(megabytes);
+}
+
+/*
+Returns the table kept between AI moves, allocating it on first use.
+Stored values depend on the utility function, so the table is cleared when it changes.
+*/
+template <class S, class A>
+TranspositionTable *Game<S, A>::getTable(float (*utilityFunction)(ABSearchableState<S, A> *))
+{
+    if (!table)
+        table = std::make_shared<TranspositionTable>(searchMemory);
+    else if (utilityFunction != lastUtilityFunction)
+        table->clear();
+    lastUtilityFunction = utilityFunction;
+    return table.get();
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+#include "LatencyHistogram.h"
+
+/*
+Counts one latency (negative ones as 0).
+*/
+void LatencyHistogram::record(std::chrono::microseconds latency)
+{
+    uint64_t micros = std::max<int64_t>(latency.count(), 0);
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t largest = max.load(std::memory_order_relaxed);
+    while (micros > largest && !max.compare_exchange_weak(largest, micros, std::memory_order_relaxed))
+        ;
+}
+
+/*
+Forgets every latency recorded.  Not atomic with concurrent record() calls.
+*/
+void LatencyHistogram::clear()
+{
+    for (auto &bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+/*
+Latency that percent of the latencies recorded are at or below, rounded up
+to the limit of its bucket (but never above the largest one recorded).
+Returns 0 if nothing has been recorded.
+*/
+std::chrono::microseconds LatencyHistogram::percentile(double percent) const
+{
+    uint64_t recorded = 0;
+    for (auto &bucket : buckets)
+        recorded += bucket.load(std::memory_order_relaxed);
+    if (recorded == 0)
+        return std::chrono::microseconds(0);
+    uint64_t rank = std::max<uint64_t>(1, std::ceil(recorded * std::min(std::max(percent, 0.0), 100.0) / 100));
+    uint64_t seen = 0;
+    unsigned int index = 0;
+    for (; index + 1 < HISTOGRAM_BUCKETS; index++)
+    {
+        seen += buckets[index].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            break;
+    }
+    return std::chrono::microseconds(std::min(bucketLimit(index), max.load(std::memory_order_relaxed)));
+}
+
+std::chrono::microseconds LatencyHistogram::getMax() const
+{
+    return std::chrono::microseconds(max.load(std::memory_order_relaxed));
+}
+
+double LatencyHistogram::getMean() const
+{
+    uint64_t recorded = getCount();
+    return recorded ? (double)total.load(std::memory_order_relaxed) / recorded : 0;
+}
+
+/*
+Bucket of micros: values below HISTOGRAM_SUB_BUCKETS have their own, larger
+ones are placed by their highest bit and the two bits below it.
+*/
+unsigned int LatencyHistogram::bucketIndex(uint64_t micros)
+{
+    if (micros < HISTOGRAM_SUB_BUCKETS)
+        return micros;
+    unsigned int bit = 63 - __builtin_clzll(micros);
+    unsigned int sub = (micros >> (bit - 2)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_SUB_BUCKETS * (bit - 1) + sub;
+}
+
+uint64_t LatencyHistogram::bucketLimit(unsigned int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+        return index;
+    unsigned int bit = index / HISTOGRAM_SUB_BUCKETS + 1;
+    uint64_t sub = index % HISTOGRAM_SUB_BUCKETS;
+    return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (bit - 2)) - 1; //wraps to UINT64_MAX for the last bucket
+}
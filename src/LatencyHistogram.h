@@ -0,0 +1,40 @@
+#pragma once
+/*
+Histogram of latencies in microseconds, for percentiles of request times.
+Buckets are log-linear: exact below 4us, then 4 buckets per power of two,
+so a bucket's bounds are within 25% of every value in it, from microseconds
+to hours, in a fixed 2KB.  record() takes no locks and can be called from
+any thread; readers see a recent snapshot.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+//Defaults
+const unsigned int HISTOGRAM_SUB_BUCKETS = 4; //buckets per power of two
+const unsigned int HISTOGRAM_BUCKETS = HISTOGRAM_SUB_BUCKETS * 63;
+
+class LatencyHistogram
+{
+public:
+    void record(std::chrono::microseconds latency);
+    void clear();
+    std::chrono::microseconds percentile(double percent) const; //0 to 100
+
+    //getters
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); };
+    std::chrono::microseconds getMax() const;
+    double getMean() const; //microseconds
+    uint64_t getBucket(unsigned int index) const { return buckets[index].load(std::memory_order_relaxed); };
+    static uint64_t bucketLimit(unsigned int index); //largest latency (us) counted in bucket index
+
+private:
+    std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS]{};
+    std::atomic<uint64_t> count{0}, total{0}, max{0};
+
+    static unsigned int bucketIndex(uint64_t micros);
+};
+
+#include "LatencyHistogram.cpp"
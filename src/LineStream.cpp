@@ -0,0 +1,113 @@
+#pragma once
+#include "LineStream.h"
+
+/*
+Constructor
+in and out may be the same descriptor (a socket).
+*/
+LineStream::LineStream(int in, int out, bool owned) : in{in}, out{out}, owned{owned}
+{
+}
+
+LineStream::~LineStream()
+{
+    if (!owned)
+        return;
+    close(in);
+    if (out != in)
+        close(out);
+}
+
+/*
+Reads the next line into line, without its line ending.
+Returns false at the end of the input (a last line without a newline is
+still returned) or on a read error.
+*/
+bool LineStream::readLine(std::string &line)
+{
+    size_t end;
+    while ((end = buffer.find('\n')) == std::string::npos)
+    {
+        char chunk[LINE_READ_SIZE];
+        ssize_t count = read(in, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+        {
+            if (buffer.empty())
+                return false;
+            end = buffer.size();
+            break;
+        }
+        buffer.append(chunk, count);
+    }
+    line = buffer.substr(0, end);
+    buffer.erase(0, std::min(end + 1, buffer.size()));
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    return true;
+}
+
+/*
+Writes line and a newline.  Returns false if the other end has gone away.
+*/
+bool LineStream::writeLine(const std::string &line)
+{
+    std::string data = line + '\n';
+    std::lock_guard<std::mutex> guard(writeLock);
+    for (size_t written = 0; written < data.size();)
+    {
+        ssize_t count = write(out, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        written += count;
+    }
+    return true;
+}
+
+/*
+Returns a socket listening at path, replacing any socket file already there.
+Throws runtime_error if it cannot listen there.
+*/
+int LineStream::listenUnix(const std::string &path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+    path.copy(address.sun_path, path.size());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        throw std::runtime_error("cannot create socket");
+    unlink(path.c_str());
+    if (bind(listener, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener, LISTEN_BACKLOG) < 0)
+    {
+        close(listener);
+        throw std::runtime_error("cannot listen on " + path);
+    }
+    return listener;
+}
+
+/*
+Returns a socket connected to the one listening at path.
+Throws runtime_error if it cannot connect.
+*/
+int LineStream::connectUnix(const std::string &path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("socket path too long: " + path);
+    path.copy(address.sun_path, path.size());
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+        throw std::runtime_error("cannot create socket");
+    if (connect(connection, (sockaddr *)&address, sizeof(address)) < 0)
+    {
+        close(connection);
+        throw std::runtime_error("cannot connect to " + path);
+    }
+    return connection;
+}
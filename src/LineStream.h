@@ -0,0 +1,45 @@
+#pragma once
+/*
+Text line protocol over file descriptors: a Unix domain socket, or
+stdin/stdout.  readLine() is for a single reader thread; writeLine() can be
+called from any thread at the same time and writes each line whole.
+Programs using it should ignore SIGPIPE, so that writing to a peer that has
+gone away fails instead of ending the process.
+*/
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//Defaults
+const size_t LINE_READ_SIZE = 4096; //bytes read at a time
+const int LISTEN_BACKLOG = 128;     //connections waiting to be accepted
+
+class LineStream
+{
+public:
+    //construct/destruct
+    LineStream(int in, int out, bool owned = true); //owned: close the descriptors when destroyed
+    ~LineStream();
+    LineStream(const LineStream &) = delete;
+    LineStream &operator=(const LineStream &) = delete;
+
+    bool readLine(std::string &line);
+    bool writeLine(const std::string &line);
+
+    //Unix domain sockets
+    static int listenUnix(const std::string &path);
+    static int connectUnix(const std::string &path);
+
+private:
+    int in, out;
+    bool owned;
+    std::string buffer; //read but not yet returned
+    std::mutex writeLock;
+};
+
+#include "LineStream.cpp"
@@ -0,0 +1,169 @@
+#pragma once
+/*
+Monte Carlo tree search (UCT) on ABSearchableState, as a second engine
+beside alpha-beta for evaluators too noisy to prune with.
+Each iteration walks down the tree choosing children by UCB1, expands the
+leaf it reaches, plays a rollout from there to the end of the game (or
+rolloutPlies moves) and backs the result up the path.  Only the sign of the
+utility function at the end of a rollout is used: a win, draw or loss for
+the maximizing side.  Guided rollouts pick most moves by the utility function
+after one ply instead of at random.
+
+Tree parallel: every thread walks the one shared tree with its own copy of
+the state.  Nodes come from a preallocated arena and their visit counts and
+scores are atomics updated without locks.  A thread passing through a node
+adds a virtual loss to it, so the other threads spread out to other lines
+until its result is backed up.
+*/
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "ABSearch.h"
+#include "Bot.h"
+#include "ThreadPool.h"
+
+//Defaults
+const size_t DEFAULT_MCTS_NODES = 1 << 20;   //arena capacity
+const float DEFAULT_EXPLORATION = 1.4;       //UCB1 exploration constant (about sqrt(2) for scores in [0, 1])
+const unsigned int DEFAULT_VIRTUAL_LOSS = 3; //losses added to a node while a thread is below it
+const float DEFAULT_GREEDY_RATE = 0.8;       //share of guided rollout moves chosen by the utility function
+const unsigned int MAX_ROLLOUT_PLIES = 1000; //longer rollouts are scored where they stop
+const uint32_t NO_NODE = UINT32_MAX;
+
+/*
+Optional MCTS settings.
+*/
+struct MCTSOptions
+{
+    unsigned int threads = 0;                 //search threads (0 = hardware_concurrency())
+    ThreadPool *pool = nullptr;               //where helper threads come from (nullptr = ThreadPool::shared())
+    size_t maxRollouts = 0;                   //stop after this many rollouts on all threads (0 = no limit)
+    size_t maxNodes = DEFAULT_MCTS_NODES;     //tree size; once full, leaves are no longer expanded
+    float exploration = DEFAULT_EXPLORATION;
+    unsigned int virtualLoss = DEFAULT_VIRTUAL_LOSS; //0 lets threads pile onto the same line
+    bool guidedRollouts = false;              //rollout moves by the utility function instead of at random
+    float greedyRate = DEFAULT_GREEDY_RATE;   //guided rollouts only
+    unsigned int rolloutPlies = 0;            //score rollouts after this many moves (0 = at the end of the game)
+    uint64_t seed = 1;                        //rollouts of thread i use seed + i
+    SearchControl *control = nullptr;         //stop through this control instead, with no thinkTime deadline
+};
+
+/*
+Outcome of a search.  Scores are the maximizing side's share of the points
+(1 a win, 0.5 a draw) in the rollouts through a move.
+*/
+template <class A>
+struct MCTSResult
+{
+    A move{};                   //most visited root move
+    float score = 0;            //its score
+    size_t rollouts = 0;
+    size_t nodes = 0;           //tree nodes allocated
+    double seconds = 0;         //wall time
+    std::vector<A> moves;       //root moves, in search order
+    std::vector<size_t> visits; //rollouts through each
+    std::vector<float> scores;  //and their scores
+
+    double rolloutsPerSecond() const { return seconds > 0 ? rollouts / seconds : 0; };
+};
+
+/*
+Tree node.  The fields besides the atomics are written by the thread that
+allocates the node, before its parent publishes it by setting expansion.
+*/
+template <class A>
+struct MCTSNode
+{
+    std::atomic<uint32_t> visits;    //rollouts through the node, plus virtual losses in progress
+    std::atomic<uint32_t> score;     //half points (2 a win, 1 a draw) for the side that moved here
+    std::atomic<uint32_t> children;  //arena index of the first child
+    std::atomic<uint8_t> expansion;  //MCTSArena::Expansion
+    uint8_t childCount;
+    A action;                        //move from the parent
+};
+
+/*
+Preallocated node storage.  Nodes are handed out in blocks of siblings by
+an atomic counter and all freed at once by clear().  The memory is only
+touched as nodes are handed out, so a large arena costs nothing up front.
+*/
+template <class A>
+class MCTSArena
+{
+public:
+    enum Expansion : uint8_t
+    {
+        LEAF = 0,  //not expanded yet
+        EXPANDING, //another thread is expanding it
+        EXPANDED,  //children can be read
+        TERMINAL,  //end of the game
+        FULL       //the arena had no room for its children
+    };
+
+    //construct/destruct
+    MCTSArena(size_t capacity = DEFAULT_MCTS_NODES);
+    ~MCTSArena() { ::operator delete(nodes); };
+    MCTSArena(const MCTSArena &) = delete;
+    MCTSArena &operator=(const MCTSArena &) = delete;
+
+    void clear() { used.store(0, std::memory_order_relaxed); };
+    uint32_t allocate(unsigned int count);
+    MCTSNode<A> &operator[](uint32_t index) { return nodes[index]; };
+
+    //getters
+    size_t getCapacity() const { return capacity; };
+    size_t getUsed() const { return std::min(used.load(std::memory_order_relaxed), capacity); };
+
+private:
+    MCTSNode<A> *nodes; //raw memory, nodes are constructed by allocate()
+    size_t capacity;
+    std::atomic<size_t> used{0};
+};
+
+template <class S, class A>
+class MCTS
+{
+public:
+    static MCTSResult<A> search(ABSearchableState<S, A> *state,
+                                float (*utilityFunction)(ABSearchableState<S, A> *),
+                                std::chrono::milliseconds thinkTime = DEFAULT_TIME,
+                                bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                                MCTSArena<A> *arena = nullptr,
+                                const MCTSOptions &options = MCTSOptions());
+    static A getMove(ABSearchableState<S, A> *state,
+                     float (*utilityFunction)(ABSearchableState<S, A> *),
+                     std::chrono::milliseconds thinkTime = DEFAULT_TIME,
+                     bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                     MCTSArena<A> *arena = nullptr,
+                     const MCTSOptions &options = MCTSOptions());
+
+private:
+    typedef ABSearchableState<S, A> state_type;
+
+    /*
+    Settings and shared tree of one search.
+    */
+    struct Context
+    {
+        float (*utilityFunction)(state_type *);
+        bool (*maxLayerFunction)(state_type *);
+        const MCTSOptions &options;
+        MCTSArena<A> &arena;
+        uint32_t root;
+        SearchControl &control;
+    };
+
+    static void run(state_type *root, Context &context, unsigned int thread, size_t &rollouts);
+    static bool expand(state_type *state, uint32_t index, Context &context);
+    static uint32_t select(uint32_t index, Context &context);
+    static unsigned int rollout(state_type *state, int color, Context &context, std::mt19937 &random);
+    static int layerColor(state_type *state, int parentColor, Context &context);
+};
+
+#include "MCTS.tpp"
@@ -0,0 +1,357 @@
+#pragma once
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include "MCTS.h"
+
+/*
+Constructor
+Reserves room for capacity nodes.
+Throws invalid_argument if capacity doesn't fit a node index.
+*/
+template <class A>
+MCTSArena<A>::MCTSArena(size_t capacity) : capacity{capacity}
+{
+    static_assert(std::is_trivially_destructible<A>::value, "nodes are freed without destroying them");
+    if (capacity >= NO_NODE)
+        throw std::invalid_argument("arena capacity must be less than " + std::to_string(NO_NODE));
+    nodes = static_cast<MCTSNode<A> *>(::operator new(capacity * sizeof(MCTSNode<A>)));
+}
+
+/*
+Hands out count consecutive fresh nodes (a leaf with no visits each) and
+returns the index of the first, or NO_NODE if the arena is full.
+Safe to call from any thread.
+*/
+template <class A>
+uint32_t MCTSArena<A>::allocate(unsigned int count)
+{
+    size_t first = used.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > capacity)
+        return NO_NODE;
+    for (size_t i = first; i < first + count; i++)
+    {
+        MCTSNode<A> &node = *new (&nodes[i]) MCTSNode<A>;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.score.store(0, std::memory_order_relaxed);
+        node.children.store(NO_NODE, std::memory_order_relaxed);
+        node.expansion.store(LEAF, std::memory_order_relaxed);
+        node.childCount = 0;
+    }
+    return first;
+}
+
+/*
+Searches state for thinkTime (or until options.maxRollouts, or
+options.control is stopped) and returns the most visited move.
+utilityFunction scores the ends of rollouts for the maximizing side, and
+maxLayerFunction tells which layers are the maximizing side's (nullptr
+alternates); the root is always a maximizing layer.
+The calling thread searches too; helpers run as tasks on the thread pool.
+arena holds the tree, cleared first; if nullptr, one of options.maxNodes is
+allocated for this call only.
+Throws invalid_argument if the game is already over or the arena has no
+room for the root's moves.
+*/
+template <class S, class A>
+MCTSResult<A> MCTS<S, A>::search(ABSearchableState<S, A> *state,
+                                 float (*utilityFunction)(ABSearchableState<S, A> *),
+                                 std::chrono::milliseconds thinkTime,
+                                 bool (*maxLayerFunction)(ABSearchableState<S, A> *),
+                                 MCTSArena<A> *arena, const MCTSOptions &options)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (state->isABTerminalState())
+        throw std::invalid_argument("the game is over");
+    std::unique_ptr<MCTSArena<A>> localArena;
+    if (arena == nullptr)
+    {
+        localArena.reset(new MCTSArena<A>(options.maxNodes));
+        arena = localArena.get();
+    }
+    arena->clear();
+    size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+
+    //A rollout costs far more than polling, so poll after each one
+    SearchControl localControl(1);
+    SearchControl &control = options.control ? *options.control : localControl;
+    if (!options.control)
+        control.setDeadline(startTime + thinkTime);
+    control.setNodeLimit(options.maxRollouts);
+    Context context = {utilityFunction, maxLayerFunction, options, *arena, arena->allocate(1), control};
+
+    //Expand the root up front, so every rollout goes through a root move
+    {
+        std::unique_ptr<state_type> rootState(state->clone());
+        if (context.root == NO_NODE || !expand(rootState.get(), context.root, context))
+            throw std::invalid_argument("arena has no room for the root's moves");
+    }
+
+    std::mutex resultLock;
+    std::exception_ptr error;
+    size_t rollouts = 0;
+    auto work = [&](unsigned int thread)
+    {
+        size_t threadRollouts = 0;
+        try
+        {
+            run(state, context, thread, threadRollouts);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> guard(resultLock);
+            error = std::current_exception();
+            control.stop();
+        }
+        std::lock_guard<std::mutex> guard(resultLock);
+        rollouts += threadRollouts;
+    };
+    ThreadPool &pool = options.pool ? *options.pool : ThreadPool::shared();
+    TaskGroup helpers;
+    for (unsigned int i = 1; i < threads; i++)
+        helpers.run(pool, [&work, i]
+                    { work(i); });
+    work(0);
+    control.stop(); //main thread is done, so are the helpers
+    helpers.wait();
+    if (error)
+        std::rethrow_exception(error);
+
+    MCTSResult<A> result;
+    MCTSNode<A> &rootNode = (*arena)[context.root];
+    size_t bestVisits = 0;
+    for (uint32_t i = 0; i < rootNode.childCount; i++)
+    {
+        MCTSNode<A> &child = (*arena)[rootNode.children + i];
+        size_t visits = child.visits.load(std::memory_order_relaxed);
+        float score = visits ? child.score.load(std::memory_order_relaxed) / (2.0f * visits) : 0;
+        result.moves.push_back(child.action);
+        result.visits.push_back(visits);
+        result.scores.push_back(score);
+        if (i == 0 || visits > bestVisits)
+        {
+            bestVisits = visits;
+            result.move = child.action;
+            result.score = score;
+        }
+    }
+    result.rollouts = rollouts;
+    result.nodes = arena->getUsed();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+/*
+Returns the most visited move of search().
+*/
+template <class S, class A>
+A MCTS<S, A>::getMove(ABSearchableState<S, A> *state, float (*utilityFunction)(ABSearchableState<S, A> *),
+                      std::chrono::milliseconds thinkTime, bool (*maxLayerFunction)(ABSearchableState<S, A> *),
+                      MCTSArena<A> *arena, const MCTSOptions &options)
+{
+    return search(state, utilityFunction, thinkTime, maxLayerFunction, arena, options).move;
+}
+
+/*
+One search thread: selection, expansion, rollout and backup until the
+control stops, on its own copy of root.  Adds its rollouts to rollouts.
+*/
+template <class S, class A>
+void MCTS<S, A>::run(state_type *root, Context &context, unsigned int thread, size_t &rollouts)
+{
+    std::unique_ptr<state_type> state(root->clone());
+    std::mt19937 random(context.options.seed + thread);
+    unsigned int virtualLoss = context.options.virtualLoss;
+    std::vector<uint32_t> path;
+    std::vector<int> colors; //side to move at each node of path
+    while (!context.control.stopped())
+    {
+        //Selection: follow UCB1 down to a leaf, adding virtual losses on the way
+        uint32_t index = context.root;
+        int color = 1;
+        path.assign(1, index);
+        colors.assign(1, color);
+        while (true)
+        {
+            MCTSNode<A> &node = context.arena[index];
+            uint8_t expansion = node.expansion.load(std::memory_order_acquire);
+            //Expansion: leaves are expanded once visited before, so one-off leaves cost no nodes
+            if (expansion == MCTSArena<A>::LEAF && node.visits.load(std::memory_order_relaxed) > virtualLoss)
+            {
+                expand(state.get(), index, context);
+                expansion = node.expansion.load(std::memory_order_acquire);
+            }
+            if (expansion != MCTSArena<A>::EXPANDED)
+                break;
+            index = select(index, context);
+            MCTSNode<A> &child = context.arena[index];
+            child.visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+            state->doAction(child.action);
+            color = layerColor(state.get(), color, context);
+            path.push_back(index);
+            colors.push_back(color);
+        }
+
+        unsigned int points = rollout(state.get(), color, context, random);
+        for (size_t i = 1; i < path.size(); i++)
+            state->undoAction();
+
+        //Backup: score each node for the side that moved into it, and take back the virtual loss
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            MCTSNode<A> &node = context.arena[path[i]];
+            int mover = i == 0 ? 1 : colors[i - 1];
+            node.score.fetch_add(mover > 0 ? points : 2 - points, std::memory_order_relaxed);
+            if (i > 0 && virtualLoss > 0)
+                node.visits.fetch_sub(virtualLoss - 1, std::memory_order_relaxed);
+            else
+                node.visits.fetch_add(1, std::memory_order_relaxed);
+        }
+        rollouts++;
+        if (context.control.poll(1))
+            break;
+    }
+}
+
+/*
+Gives the leaf at index, where state is, a child for each move, or marks it
+terminal (or full if the arena has no room).
+Only one thread expands a node; the others carry on as if it were a leaf.
+Returns true if the node ends up expanded.
+*/
+template <class S, class A>
+bool MCTS<S, A>::expand(state_type *state, uint32_t index, Context &context)
+{
+    MCTSNode<A> &node = context.arena[index];
+    uint8_t expected = MCTSArena<A>::LEAF;
+    if (!node.expansion.compare_exchange_strong(expected, MCTSArena<A>::EXPANDING, std::memory_order_acq_rel))
+        return expected == MCTSArena<A>::EXPANDED;
+    ActionList<A> actions;
+    if (!state->isABTerminalState())
+        state->generateActions(actions);
+    if (actions.empty())
+    {
+        node.expansion.store(MCTSArena<A>::TERMINAL, std::memory_order_release);
+        return false;
+    }
+    uint32_t first = context.arena.allocate(actions.size());
+    if (first == NO_NODE)
+    {
+        node.expansion.store(MCTSArena<A>::FULL, std::memory_order_release);
+        return false;
+    }
+    //Hinted moves first, so they are the first tried
+    int hints[MAX_ACTIONS];
+    unsigned int order[MAX_ACTIONS];
+    for (unsigned int i = 0; i < actions.size(); i++)
+    {
+        hints[i] = state->actionHint(actions[i]);
+        order[i] = i;
+    }
+    std::stable_sort(order, order + actions.size(), [&hints](unsigned int x, unsigned int y)
+                     { return hints[x] > hints[y]; });
+    for (unsigned int i = 0; i < actions.size(); i++)
+        context.arena[first + i].action = actions[order[i]];
+    node.childCount = actions.size();
+    node.children.store(first, std::memory_order_relaxed);
+    node.expansion.store(MCTSArena<A>::EXPANDED, std::memory_order_release);
+    return true;
+}
+
+/*
+Child of the expanded node at index with the highest UCB1 value for the side
+to move: its score plus an exploration bonus that shrinks as it is visited.
+Unvisited children come first.  Virtual losses count as visits without
+points, so a line being searched by another thread looks worse.
+*/
+template <class S, class A>
+uint32_t MCTS<S, A>::select(uint32_t index, Context &context)
+{
+    MCTSNode<A> &node = context.arena[index];
+    uint32_t first = node.children.load(std::memory_order_relaxed);
+    float logVisits = std::log((float)std::max(node.visits.load(std::memory_order_relaxed), 1u));
+    uint32_t best = first;
+    float bestValue = -INFINITY;
+    for (uint32_t i = first; i < first + node.childCount; i++)
+    {
+        MCTSNode<A> &child = context.arena[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return i;
+        float value = child.score.load(std::memory_order_relaxed) / (2.0f * visits) +
+                      context.options.exploration * std::sqrt(logVisits / visits);
+        if (value > bestValue)
+        {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/*
+Plays on from state, with color to move, to the end of the game (or
+options.rolloutPlies moves), then restores state.  Returns the maximizing
+side's half points: 2 if the utility function is then positive, 1 if it is
+zero, 0 if it is negative.  A state with a known result (resolveExact())
+goes straight to it.
+*/
+template <class S, class A>
+unsigned int MCTS<S, A>::rollout(state_type *state, int color, Context &context, std::mt19937 &random)
+{
+    float utility;
+    if (state->resolveExact())
+    {
+        utility = context.utilityFunction(state);
+        state->undoAction();
+    }
+    else
+    {
+        const MCTSOptions &options = context.options;
+        unsigned int limit = options.rolloutPlies ? std::min(options.rolloutPlies, MAX_ROLLOUT_PLIES)
+                                                  : MAX_ROLLOUT_PLIES;
+        unsigned int plies = 0;
+        ActionList<A> actions;
+        for (; plies < limit && !state->isABTerminalState(); plies++)
+        {
+            actions.clear();
+            state->generateActions(actions);
+            unsigned int choice = std::uniform_int_distribution<unsigned int>(0, actions.size() - 1)(random);
+            if (options.guidedRollouts && std::uniform_real_distribution<float>(0, 1)(random) < options.greedyRate)
+            {
+                //Greedy: the move after which the utility function likes the mover's position best
+                float bestValue = -INFINITY;
+                for (unsigned int i = 0; i < actions.size(); i++)
+                {
+                    state->doAction(actions[i]);
+                    float value = color * context.utilityFunction(state);
+                    state->undoAction();
+                    if (value > bestValue)
+                    {
+                        bestValue = value;
+                        choice = i;
+                    }
+                }
+            }
+            state->doAction(actions[choice]);
+            color = layerColor(state, color, context);
+        }
+        utility = context.utilityFunction(state);
+        for (; plies > 0; plies--)
+            state->undoAction();
+    }
+    return utility > 0 ? 2 : utility < 0 ? 0 : 1;
+}
+
+/*
+Side to move at state (1 maximizing, -1 minimizing), given the side that
+moved to it.
+*/
+template <class S, class A>
+int MCTS<S, A>::layerColor(state_type *state, int parentColor, Context &context)
+{
+    if (context.maxLayerFunction == nullptr)
+        return -parentColor;
+    return context.maxLayerFunction(state) ? 1 : -1;
+}
@@ -25,58 +25,169 @@ Store
 
 */
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <iostream>
 #include "Game.h"
+#include "MancalaTablebase.h"
+#include "Zobrist.h"
+
+//SSE2 board kernels for compile-time boards of up to 16 pits (define MANCALA_SCALAR to disable)
+#if defined(__SSE2__) && !defined(MANCALA_SCALAR)
+#include <emmintrin.h>
+#define MANCALA_SIMD 1
+#else
+#define MANCALA_SIMD 0
+#endif
+//Vector sowing is opt-in: the hash needs every changed pit anyway, and the
+//arithmetic scalar sowing measured faster on these boards
+#ifndef MANCALA_SIMD_SOWING
+#define MANCALA_SIMD_SOWING 0
+#endif
 
 typedef std::vector<unsigned int> state_t;
 typedef unsigned int action_t;
 
+/*
+Everything needed to revert one move in place.
+*/
+struct MancalaUndo
+{
+    action_t pit;          //pit that was sown
+    unsigned int stones;   //stones taken from pit (0 if the move did nothing)
+    unsigned int endPit;   //last pit sown into
+    unsigned int captured; //stones taken from the opposite pit (0 if no capture)
+    bool swept;            //endgame() moved the remaining stones into the stores
+    short turn, winner;
+    bool gameStarted;
+    uint64_t boardHash;
+    int settled = 0; //stones then moved from player 2's store to player 1's (resolveExact())
+};
+
 //Some defaults
 const size_t DEFAULT_SIZE = 6;
 const unsigned int DEFAULT_STONES = 4;
 const size_t MIN_BOARD_SIZE = 4;
 
-class Mancala : public Game<state_t, action_t>
+/*
+Board storage and dimensions.
+With PitsPerSide known at compile time the board is a packed std::array and
+store/opposite pit arithmetic folds to constants.  PitsPerSide = 0 keeps the
+original runtime-sized vector board.
+*/
+template <size_t PitsPerSide>
+struct MancalaLayout
 {
-private:
-    //member variables
+    typedef std::array<uint8_t, PitsPerSide * 2 + 2> board_t;
+    static constexpr size_t size = PitsPerSide * 2 + 2;
+    static constexpr unsigned int store1 = PitsPerSide, store2 = PitsPerSide * 2 + 1;
+    static constexpr unsigned int maxStones = UINT8_MAX; //most stones a pit can hold
+    void setLayout(size_t /*boardSize*/){}; //fixed at compile time
+};
+
+template <>
+struct MancalaLayout<0>
+{
+    typedef state_t board_t;
     size_t size;
     unsigned int store1, store2;
+    static constexpr unsigned int maxStones = UINT32_MAX;
+    void setLayout(size_t boardSize)
+    {
+        size = boardSize;
+        store1 = size / 2 - 1;
+        store2 = size - 1;
+    };
+};
 
-    //construct/destruct
-    Mancala(state_t state);
-    void initialize(state_t state);
+template <size_t PitsPerSide = 0, unsigned int Stones = DEFAULT_STONES>
+class BasicMancala final : public Game<typename MancalaLayout<PitsPerSide>::board_t, action_t>,
+                     private MancalaLayout<PitsPerSide>
+{
+public:
+    typedef typename MancalaLayout<PitsPerSide>::board_t board_t;
+
+private:
+    using MancalaLayout<PitsPerSide>::size;
+    using MancalaLayout<PitsPerSide>::store1;
+    using MancalaLayout<PitsPerSide>::store2;
+    using Game<board_t, action_t>::state;
+    using Game<board_t, action_t>::turn;
+    using Game<board_t, action_t>::winner;
+    using Game<board_t, action_t>::gameStarted;
+
+    //packed boards that fit one 16 byte vector
+    static constexpr bool simd = MANCALA_SIMD && PitsPerSide > 0 && PitsPerSide * 2 + 2 <= 16;
+    static constexpr bool simdSowing = simd && MANCALA_SIMD_SOWING;
+
+    //member variables
+    std::vector<MancalaUndo> history;      //one record per move, for undoMove()
+    std::vector<unsigned int> sweptStones; //pit values removed by endgame sweeps
+    std::shared_ptr<const Zobrist> zobrist;
+    uint64_t boardHash; //Zobrist hash of the pits, kept up to date by every move
+    unsigned int totalStones;
+    std::shared_ptr<const MancalaTablebase> tablebase; //solved endgames, if any
+
+    void initialize(const board_t &state);
 
     void makeValidMove(action_t move);
     void changeTurn() { turn = (turn % 2) + 1; };
+    unsigned int nextPit(unsigned int pit) { return pit + 1 == size ? 0 : pit + 1; };
     bool isEndgame();
-    void capture(unsigned int pit);
+    unsigned int capture(unsigned int pit);
     int distribute(unsigned int pit);
-    void endgame();
+    bool endgame();
+    void settle(int settled);
+    void sweep();
+    void uncapture(unsigned int pit, unsigned int captured);
+    void undistribute(unsigned int pit, unsigned int stones);
+    void unsweep(int settled);
+    unsigned int sowingEnd(unsigned int pit, unsigned int stones);
+#if MANCALA_SIMD
+    __m128i loadBoard();
+    void storeBoard(__m128i board);
+    __m128i sowingChange(unsigned int pit, unsigned int stones);
+    __m128i sideMask(unsigned int first);
+#endif
 
 public:
     //construct/destruct
-    Mancala() : Mancala(DEFAULT_SIZE, DEFAULT_STONES){};
-    Mancala(size_t size, unsigned int stones);
-    ~Mancala(){};
+    BasicMancala() : BasicMancala(PitsPerSide ? PitsPerSide : DEFAULT_SIZE, Stones){};
+    BasicMancala(size_t size, unsigned int stones);
+    BasicMancala(const board_t &state, short turn = 1);
+    ~BasicMancala(){};
 
     //overrides
     void makeMove(action_t move) override;
-    std::vector<action_t *> getValidMoves() override;
+    void undoMove() override;
+    void getValidMoves(ActionList<action_t> &moves) override;
+    using Game<board_t, action_t>::getValidMoves;
+    bool isValidMove(action_t move) override;
     bool isABTerminalState() override { return isEndgame(); };
+    int actionHint(action_t move) override;
+    unsigned int actionId(action_t move) override { return move < MAX_ACTION_IDS ? move : NO_ACTION_ID; }; //the pit
+    bool resolveExact() override;
     size_t hash() override;
-    Mancala *clone() override;
+    size_t canonicalHash(bool &mirrored) override;
+    BasicMancala *clone() override;
 
-    //getters
+    //getters/setters
+    uint64_t legalMoveMask();
+    const board_t &getBoard() { return state; };
     int getStoneCount(unsigned int pit) { return state[pit % size]; };
     int getPlayer1Score() { return state[store1]; };
     int getPlayer2Score() { return state[store2]; };
     size_t getSize() { return size; };
     unsigned int getState(int i) { return this->state[i % size]; }
+    void setTablebase(std::shared_ptr<const MancalaTablebase> tablebase);
 
     //helpers
     void print();
 };
 
-#include "Mancala.cpp"
\ No newline at end of file
+typedef BasicMancala<> Mancala;                                    //board size chosen at runtime
+typedef BasicMancala<DEFAULT_SIZE, DEFAULT_STONES> DefaultMancala; //standard board, fixed at compile time
+
+#include "Mancala.tpp"
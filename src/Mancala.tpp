@@ -0,0 +1,672 @@
+#pragma once
+#include "Mancala.h"
+
+/*
+Constructor
+size argument determines number of pits on a player's side NOT including store
+(Ex., size = 6 will make a board with a total of 14 pits: 6 on each side + 2 stores)
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+BasicMancala<PitsPerSide, Stones>::BasicMancala(size_t size, unsigned int stones)
+{
+    // Assert size is large enough
+    if (size < MIN_BOARD_SIZE)
+        throw std::invalid_argument("size must be at least " + std::to_string(MIN_BOARD_SIZE));
+    // Assert size matches a compile-time board
+    if (PitsPerSide && size != PitsPerSide)
+        throw std::invalid_argument("size must be " + std::to_string(PitsPerSide) + " for this board type");
+    // Assert stone count
+    if (stones == 0)
+        throw std::invalid_argument("stones must be a positive number");
+    if (size * 2 * stones > this->maxStones)
+        throw std::invalid_argument("too many stones for this board type");
+
+    board_t state{};
+    if constexpr (PitsPerSide == 0)
+        state.resize(size * 2 + 2);
+    for (size_t i = 0; i < size; i++)
+    {
+        state[i] = stones;            //Player 1's side
+        state[size + 1 + i] = stones; //Player 2's side
+    }
+    initialize(state);
+}
+
+/*
+Constructor
+Sets up a position: state holds every pit, stores included, in the layout
+shown above, and turn is the player to move.  A side left empty is only
+swept into the stores by the next move.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+BasicMancala<PitsPerSide, Stones>::BasicMancala(const board_t &state, short turn)
+{
+    // Assert board shape
+    if (state.size() < MIN_BOARD_SIZE * 2 + 2 || state.size() % 2 != 0)
+        throw std::invalid_argument("board must have an even number of pits, at least " +
+                                    std::to_string(MIN_BOARD_SIZE * 2 + 2));
+    if (turn != 1 && turn != 2)
+        throw std::invalid_argument("turn must be 1 or 2");
+    // Assert stone count, as every stone may end up in one pit
+    size_t stones = 0;
+    for (auto pit : state)
+        stones += pit;
+    if (stones > this->maxStones)
+        throw std::invalid_argument("too many stones for this board type");
+    initialize(state);
+    this->turn = turn;
+}
+
+/*
+Initializes member state and variables.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::initialize(const board_t &state)
+{
+    this->setLayout(state.size());
+    this->state = state;
+    //A pit can hold every stone on the board
+    unsigned int stones = 0;
+    for (auto pit : state)
+        stones += pit;
+    totalStones = stones;
+    zobrist = Zobrist::shared(size, stones + 1);
+    boardHash = zobrist->hash(state);
+}
+
+/*
+Finds all pits on the current player's side with >0 stones.
+Fills moves with the valid pit numbers.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::getValidMoves(ActionList<action_t> &moves)
+{
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    for (unsigned int j = first; j < first + store1; j++)
+        if (state[j] > 0)
+            moves.push_back(j);
+}
+
+/*
+Checks a move without generating the move list.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+bool BasicMancala<PitsPerSide, Stones>::isValidMove(action_t move)
+{
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    return move >= first && move < first + store1 && state[move] > 0;
+}
+
+/*
+Returns a bitmask of valid moves for the current player.
+Bit i is set if the i-th pit on their side (counting from their left) has stones.
+Only covers the first 64 pits of larger boards.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+uint64_t BasicMancala<PitsPerSide, Stones>::legalMoveMask()
+{
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    uint64_t mask = 0;
+    for (unsigned int i = 0; i < store1 && i < 64; i++)
+        if (state[first + i] > 0)
+            mask |= (uint64_t)1 << i;
+    return mask;
+}
+
+/*
+Move ordering hint for a valid move: 2 if it ends in the mover's store (extra
+turn), 1 if it captures, otherwise 0.  Works out the last pit arithmetically
+instead of making the move.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+int BasicMancala<PitsPerSide, Stones>::actionHint(action_t move)
+{
+    //Sowing cycles through the mover's pits (offset 0..store1 - 1), their store
+    //(offset store1) and the opponent's pits; store2 pits in all
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    unsigned int start = move - first, stones = state[move];
+    unsigned int end = (start + stones) % store2;
+    if (end == store1)
+        return 2;
+    if (end > store1 || stones > store2)
+        return 0;
+    //Last stone must land in an empty pit: passed over once, or the emptied start pit after one lap
+    unsigned int endPit = first + end;
+    if (stones < store2 && state[endPit] > 0)
+        return 0;
+    //Opposite pit gets a stone if the sowing wrapped around
+    return end <= start || state[store2 - endPit - 1] > 0 ? 1 : 0;
+}
+
+/*
+Ends the game with the result of perfect play if the tablebase covers the
+position: the stones left in the pits go to the stores in the split the
+tablebase gives, as if the rest of the game had been played.  undoMove()
+reverts it.
+Returns false, leaving the game as it is, if there is no tablebase, the game
+is over or too many stones are left in the pits.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+bool BasicMancala<PitsPerSide, Stones>::resolveExact()
+{
+    int value;
+    if (!tablebase || winner >= 0)
+        return false;
+    unsigned int inPlay = totalStones - state[store1] - state[store2];
+    if (inPlay > tablebase->getMaxStones() || !tablebase->probe(state, turn, value))
+        return false;
+    //Mover wins (inPlay + value) / 2 of the stones in play; player 1 keeps their side's
+    unsigned int player1Wins = turn == 1 ? (inPlay + value) / 2 : (inPlay - value) / 2;
+    unsigned int player1Side = 0;
+    for (unsigned int i = 0; i < store1; i++)
+        player1Side += state[i];
+    MancalaUndo undo = {(action_t)size, 0, (unsigned int)size, 0, true, turn, winner, gameStarted, boardHash};
+    undo.settled = (int)player1Wins - (int)player1Side;
+    settle(undo.settled);
+    history.push_back(undo);
+    return true;
+}
+
+/*
+Uses tablebase (shared with clones of this game) to end searches early, see
+resolveExact().  nullptr stops using one.
+Throws invalid_argument if tablebase is for another board size.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::setTablebase(std::shared_ptr<const MancalaTablebase> tablebase)
+{
+    if (tablebase && tablebase->getPitsPerSide() != store1)
+        throw std::invalid_argument("tablebase is for a board with " +
+                                    std::to_string(tablebase->getPitsPerSide()) + " pits a side");
+    this->tablebase = tablebase;
+}
+
+/*
+Returns a pointer to a clone of the game.
+Calling function is responsible for freeing.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+BasicMancala<PitsPerSide, Stones> *BasicMancala<PitsPerSide, Stones>::clone()
+{
+    BasicMancala *newMancala = new BasicMancala(this->state);
+    newMancala->turn = this->turn;
+    newMancala->winner = this->winner;
+    newMancala->gameStarted = this->gameStarted;
+    newMancala->tablebase = this->tablebase;
+    return newMancala;
+}
+
+/*
+Returns a numeric hash of the game state based on
+pit values and current player turn.
+The pit part is maintained incrementally by moves, so this is O(1).
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+size_t BasicMancala<PitsPerSide, Stones>::hash()
+{
+    return boardHash ^ zobrist->sideKey(turn);
+}
+
+/*
+Hash shared by the position and its mirror image: the rows and stores
+swapped and the other player to move.  The canonical form has player 1 to
+move, so positions with player 2 to move are hashed as their mirror image
+(mirrored is set).  A utility function that scores both sides the same way
+(e.g. the store difference) is negated by the mirror.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+size_t BasicMancala<PitsPerSide, Stones>::canonicalHash(bool &mirrored)
+{
+    mirrored = turn == 2;
+    if (!mirrored)
+        return hash();
+    //Pit i of the mirror image holds the stones of pit i + store1 + 1
+    uint64_t mirrorHash = 0;
+    for (unsigned int i = 0; i <= store1; i++)
+        mirrorHash ^= zobrist->key(i, state[i + store1 + 1]) ^ zobrist->key(i + store1 + 1, state[i]);
+    return mirrorHash ^ zobrist->sideKey(1);
+}
+
+/*
+Print Mancala board to console.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::print()
+{
+    std::cout << "P2\n";          //P2 label
+    printf("%2d", state[store2]); //P2 Store
+    //P2 side
+    for (int i = store2 - 1; i > store1; i--)
+        printf("%3d", state[i]);
+    std::cout << "\n  ";
+    //P1 side
+    for (int i = 0; i < store1; i++)
+        printf("%3d", state[i]);
+    printf("%3d\n", state[store1]); //P1 Store
+    //P1 label
+    for (int i = 0; i < size / 2; i++)
+        std::cout << "   ";
+    std::cout << " P1\n";
+    printf("Player %d's turn\n", turn); //turn
+}
+
+/*
+Public function to make move.  Checks for valid move, then calls private makeValidMove().
+Throws invalid_argument exception if move is invalid.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::makeMove(action_t move)
+{
+
+    if (this->winner > 0)
+    {
+        //Keep makeMove()/undoMove() paired even when nothing happens
+        history.push_back({move, 0, move, 0, false, turn, winner, gameStarted, boardHash});
+        return;
+    }
+    if (this->isValidMove(move))
+        makeValidMove(move);
+    else
+        throw std::invalid_argument("invalid move");
+}
+
+/*
+Reverts the last move made with makeMove().
+Throws logic_error if there is no move to revert.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::undoMove()
+{
+    if (history.empty())
+        throw std::logic_error("no move to undo");
+    MancalaUndo undo = history.back();
+    history.pop_back();
+    //Restore turn first; sowing path depends on whose move it was
+    turn = undo.turn;
+    winner = undo.winner;
+    gameStarted = undo.gameStarted;
+    boardHash = undo.boardHash;
+    if (undo.swept)
+        unsweep(undo.settled);
+    if (undo.stones == 0)
+        return;
+    if (undo.captured > 0)
+        uncapture(undo.endPit, undo.captured);
+    undistribute(undo.pit, undo.stones);
+}
+
+/*
+Makes a valid move and sets Mancala for next move.
+Records what is needed to revert it in history.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::makeValidMove(action_t pit)
+{
+    MancalaUndo undo = {pit, state[pit], 0, 0, false, turn, winner, gameStarted, boardHash};
+    unsigned int endPit = distribute(pit);
+    undo.endPit = endPit;
+    undo.captured = capture(endPit);
+    undo.swept = endgame();
+    history.push_back(undo);
+    if ((turn == 1 && endPit != store1) ||
+        (turn == 2 && endPit != store2))
+        changeTurn();
+}
+
+/*
+distributes stones in pit.  Returns ending pit.
+Every full lap of the board (all pits but the opponent's store) adds the
+same number of stones to each pit, so only the last partial lap is walked
+(or with MANCALA_SIMD_SOWING, the whole move is added as one vector).
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+int BasicMancala<PitsPerSide, Stones>::distribute(unsigned int pit)
+{
+    unsigned int stones = state[pit]; //Stone count
+#if MANCALA_SIMD
+    if constexpr (simdSowing)
+    {
+        __m128i change = sowingChange(pit, stones);
+        __m128i board = _mm_add_epi8(loadBoard(), change);
+        //Hash the pits that changed
+        uint8_t sown[16];
+        _mm_storeu_si128((__m128i *)sown, board);
+        unsigned int changed = ~_mm_movemask_epi8(_mm_cmpeq_epi8(change, _mm_setzero_si128())) & 0xFFFF;
+        for (; changed; changed &= changed - 1)
+        {
+            unsigned int i = __builtin_ctz(changed);
+            zobrist->update(boardHash, i, state[i], sown[i]);
+        }
+        storeBoard(board);
+        return sowingEnd(pit, stones);
+    }
+#endif
+    zobrist->update(boardHash, pit, stones, 0);
+    state[pit] = 0; //Clear pit
+    //Distribute, skipping the opponent's store
+    unsigned int opponentStore = turn == 1 ? store2 : store1;
+    unsigned int laps = stones / store2;
+    if (laps > 0)
+        for (unsigned int i = 0; i < size; i++)
+            if (i != opponentStore)
+            {
+                zobrist->update(boardHash, i, state[i], state[i] + laps);
+                state[i] += laps;
+            }
+    for (unsigned int left = stones % store2; left > 0;)
+    {
+        pit = nextPit(pit);
+        if (pit != opponentStore)
+        {
+            zobrist->update(boardHash, pit, state[pit], state[pit] + 1);
+            state[pit] += 1;
+            left -= 1;
+        }
+    }
+    return sowingEnd(pit, 0);
+}
+
+/*
+Reverses distribute() by removing the stones it added.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::undistribute(unsigned int pit, unsigned int stones)
+{
+#if MANCALA_SIMD
+    if constexpr (simdSowing)
+    {
+        storeBoard(_mm_sub_epi8(loadBoard(), sowingChange(pit, stones)));
+        return;
+    }
+#endif
+    unsigned int opponentStore = turn == 1 ? store2 : store1;
+    unsigned int laps = stones / store2;
+    if (laps > 0)
+        for (unsigned int i = 0; i < size; i++)
+            if (i != opponentStore)
+                state[i] -= laps;
+    for (unsigned int i = pit, left = stones % store2; left > 0;)
+    {
+        i = nextPit(i);
+        if (i != opponentStore)
+        {
+            state[i] -= 1;
+            left -= 1;
+        }
+    }
+    state[pit] = stones; //Set last; it got a stone on every lap
+}
+
+/*
+Pit where sowing stones from pit ends.
+Sowing cycles through the mover's pits (offsets 0..store1 - 1), their store
+(offset store1) and the opponent's pits; store2 pits in all.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+unsigned int BasicMancala<PitsPerSide, Stones>::sowingEnd(unsigned int pit, unsigned int stones)
+{
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    unsigned int offset = (pit + size - first) % size;
+    unsigned int end = first + (offset + stones) % store2;
+    return end >= size ? end - size : end;
+}
+
+#if MANCALA_SIMD
+/*
+Packed board as a vector; lanes past the board are 0.
+Moved through memory in the same pieces every time (8 bytes, then 4 and/or
+2 bytes), so loads are forwarded from the previous move's stores.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+__m128i BasicMancala<PitsPerSide, Stones>::loadBoard()
+{
+    constexpr size_t rest = PitsPerSide * 2 - 6; //pits after the first 8
+    const uint8_t *pits = state.data();
+    uint64_t low, high = 0;
+    uint32_t word;
+    uint16_t half;
+    std::memcpy(&low, pits, 8);
+    if constexpr (rest == 8)
+        std::memcpy(&high, pits + 8, 8);
+    if constexpr (rest == 4 || rest == 6)
+    {
+        std::memcpy(&word, pits + 8, 4);
+        high = word;
+    }
+    if constexpr (rest == 2 || rest == 6)
+    {
+        std::memcpy(&half, pits + 8 + rest - 2, 2);
+        high |= (uint64_t)half << (rest - 2) * 8;
+    }
+    return _mm_unpacklo_epi64(_mm_cvtsi64_si128(low), _mm_cvtsi64_si128(high));
+}
+
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::storeBoard(__m128i board)
+{
+    constexpr size_t rest = PitsPerSide * 2 - 6;
+    uint8_t *pits = state.data();
+    uint64_t low = _mm_cvtsi128_si64(board), high = _mm_cvtsi128_si64(_mm_unpackhi_epi64(board, board));
+    std::memcpy(pits, &low, 8);
+    if constexpr (rest == 8)
+        std::memcpy(pits + 8, &high, 8);
+    if constexpr (rest == 4 || rest == 6)
+    {
+        uint32_t word = (uint32_t)high;
+        std::memcpy(pits + 8, &word, 4);
+    }
+    if constexpr (rest == 2 || rest == 6)
+    {
+        uint16_t half = (uint16_t)(high >> (rest - 2) * 8);
+        std::memcpy(pits + 8 + rest - 2, &half, 2);
+    }
+}
+
+/*
+Change to every pit when the mover sows stones from pit: the stones leave
+pit, then each pit but the opponent's store gets one per full lap, plus one
+for the first stones % store2 pits after pit.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+__m128i BasicMancala<PitsPerSide, Stones>::sowingChange(unsigned int pit, unsigned int stones)
+{
+    const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    unsigned int first = turn == 1 ? 0 : store1 + 1;
+    unsigned int opponentStore = turn == 1 ? store2 : store1;
+    //Offset of every pit along the mover's path ((index - first) mod size)
+    __m128i offset = _mm_add_epi8(index, _mm_set1_epi8(size - first));
+    offset = _mm_min_epu8(offset, _mm_sub_epi8(offset, _mm_set1_epi8(size)));
+    //Distance from pit along the path ((offset - pit's offset) mod store2, 0 at pit)
+    unsigned int start = (pit + size - first) % size;
+    __m128i distance = _mm_add_epi8(offset, _mm_set1_epi8(store2 - start));
+    distance = _mm_min_epu8(distance, _mm_sub_epi8(distance, _mm_set1_epi8(store2)));
+    //Last partial lap: 1 <= distance <= stones % store2
+    __m128i before = _mm_sub_epi8(distance, _mm_set1_epi8(1));
+    __m128i rest = _mm_set1_epi8(stones % store2);
+    __m128i pastRest = _mm_cmpeq_epi8(_mm_max_epu8(before, rest), before);
+    __m128i change = _mm_add_epi8(_mm_set1_epi8(stones / store2),
+                                  _mm_andnot_si128(pastRest, _mm_set1_epi8(1)));
+    __m128i onBoard = _mm_cmplt_epi8(index, _mm_set1_epi8(size));
+    __m128i skipped = _mm_cmpeq_epi8(index, _mm_set1_epi8(opponentStore));
+    change = _mm_and_si128(change, _mm_andnot_si128(skipped, onBoard));
+    __m128i emptied = _mm_and_si128(_mm_cmpeq_epi8(index, _mm_set1_epi8(pit)), _mm_set1_epi8(stones));
+    return _mm_sub_epi8(change, emptied);
+}
+
+/*
+Lanes of the pits on the side starting at first.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+__m128i BasicMancala<PitsPerSide, Stones>::sideMask(unsigned int first)
+{
+    const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_and_si128(_mm_cmpgt_epi8(index, _mm_set1_epi8(first - 1)),
+                         _mm_cmplt_epi8(index, _mm_set1_epi8(first + store1)));
+}
+#endif
+
+/*
+Performs a capture of the pit opposite to int pit.
+Returns the number of stones taken from the opposite pit (0 if no capture).
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+unsigned int BasicMancala<PitsPerSide, Stones>::capture(unsigned int pit)
+{
+    //Ending pit was empty and was NOT a player store
+    if (state[pit] == 1 && pit != store1 && pit != store2)
+    {
+        int capPit = store2 - pit - 1; //Opposite pit
+        //If the opposite pit has stones
+        if (state[capPit] > 0)
+        {
+            unsigned int store;
+            if (turn == 1 && pit < store1) //Valid P1 capture
+                store = store1;
+            else if (turn == 2 && pit > store1) //Valid P2 capture
+                store = store2;
+            else //No capture
+                return 0;
+            unsigned int captured = state[capPit];
+            zobrist->update(boardHash, store, state[store], state[store] + captured + 1);
+            state[store] += captured + 1;
+            //clear the pits
+            zobrist->update(boardHash, pit, 1, 0);
+            zobrist->update(boardHash, capPit, captured, 0);
+            state[pit] = 0;
+            state[capPit] = 0;
+            return captured;
+        }
+    }
+    return 0;
+}
+
+/*
+Reverses a capture that ended in pit.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::uncapture(unsigned int pit, unsigned int captured)
+{
+    unsigned int store = turn == 1 ? store1 : store2;
+    state[store] -= captured + 1;
+    state[pit] = 1;
+    state[store2 - pit - 1] = captured;
+}
+
+/*
+Perform endgame actions.
+Returns true if the remaining stones were swept into the stores.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+bool BasicMancala<PitsPerSide, Stones>::endgame()
+{
+    if (isEndgame())
+    {
+        settle(0);
+        return true;
+    }
+    return false;
+}
+
+/*
+Ends the game: collects the remaining stones into their side's store, moves
+settled stones from player 2's store to player 1's (negative moves them the
+other way) and sets the winner.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::settle(int settled)
+{
+    //Collect remaining stones and move to stores
+    unsigned int oldStore1 = state[store1], oldStore2 = state[store2];
+    for (unsigned int i = 0; i < store1; i++)
+    {
+        sweptStones.push_back(state[i]);
+        sweptStones.push_back(state[store2 - i - 1]);
+        zobrist->update(boardHash, i, state[i], 0);
+        zobrist->update(boardHash, store2 - i - 1, state[store2 - i - 1], 0);
+    }
+    sweep();
+    state[store1] += settled;
+    state[store2] -= settled;
+    zobrist->update(boardHash, store1, oldStore1, state[store1]);
+    zobrist->update(boardHash, store2, oldStore2, state[store2]);
+    //get winner
+    if (state[store1] > state[store2])
+        winner = 1;
+    else if (state[store2] > state[store1])
+        winner = 2;
+    else
+        winner = 0; //tie
+}
+
+/*
+Moves the stones on each side into that side's store.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::sweep()
+{
+#if MANCALA_SIMD
+    if constexpr (simd)
+    {
+        __m128i board = loadBoard(), zero = _mm_setzero_si128();
+        __m128i side1 = sideMask(0), side2 = sideMask(store1 + 1);
+        //Side sums (a partial sum in each half of the vector)
+        __m128i sum1 = _mm_sad_epu8(_mm_and_si128(board, side1), zero);
+        __m128i sum2 = _mm_sad_epu8(_mm_and_si128(board, side2), zero);
+        storeBoard(_mm_andnot_si128(_mm_or_si128(side1, side2), board));
+        state[store1] += _mm_cvtsi128_si32(sum1) + _mm_extract_epi16(sum1, 4);
+        state[store2] += _mm_cvtsi128_si32(sum2) + _mm_extract_epi16(sum2, 4);
+        return;
+    }
+#endif
+    for (unsigned int i = 0; i < store1; i++)
+    {
+        state[store1] += state[i];
+        state[store2] += state[store2 - i - 1];
+        state[i] = 0;
+        state[store2 - i - 1] = 0;
+    }
+}
+
+/*
+Reverses the last settle().
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+void BasicMancala<PitsPerSide, Stones>::unsweep(int settled)
+{
+    state[store1] -= settled;
+    state[store2] += settled;
+    for (int i = store1 - 1; i >= 0; i--)
+    {
+        state[store2 - i - 1] = sweptStones.back();
+        state[store2] -= sweptStones.back();
+        sweptStones.pop_back();
+        state[i] = sweptStones.back();
+        state[store1] -= sweptStones.back();
+        sweptStones.pop_back();
+    }
+}
+
+/*
+Check for empty side and return true if either side is empty.
+*/
+template <size_t PitsPerSide, unsigned int Stones>
+bool BasicMancala<PitsPerSide, Stones>::isEndgame()
+{
+#if MANCALA_SIMD
+    if constexpr (simd)
+    {
+        //Bit i set if pit i is empty
+        unsigned int empty = _mm_movemask_epi8(_mm_cmpeq_epi8(loadBoard(), _mm_setzero_si128()));
+        unsigned int side1 = (1u << store1) - 1, side2 = side1 << (store1 + 1);
+        return (empty & side1) == side1 || (empty & side2) == side2;
+    }
+#endif
+    int pitCount1 = 0, pitCount2 = 0;
+    //Count stones on each side
+    for (int i = 0; i < store1; i++)
+    {
+        pitCount1 += state[i];
+        pitCount2 += state[store2 - i - 1];
+    }
+    return (pitCount1 == 0 || pitCount2 == 0);
+}
\ No newline at end of file
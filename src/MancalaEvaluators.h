@@ -0,0 +1,39 @@
+#pragma once
+/*
+Utility and layer functions for DefaultMancala, with Player (1 or 2) as the
+maximizing side, shared by the programs that pit bots against each other.
+*/
+#include "Mancala.h"
+
+/*
+Store difference for Player.
+*/
+template <int Player>
+float stores(ABSearchableState<DefaultMancala::board_t, action_t> *state)
+{
+    DefaultMancala *game = (DefaultMancala *)state;
+    float utility = (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
+    return Player == 1 ? utility : -utility;
+}
+
+/*
+playMancala's utility1 for Player, without its random noise.
+*/
+template <int Player>
+float utility1(ABSearchableState<DefaultMancala::board_t, action_t> *state)
+{
+    DefaultMancala *game = (DefaultMancala *)state;
+    float utility = (float)game->getPlayer1Score() - (float)game->getPlayer2Score();
+    utility += ((float)game->getState(game->getSize() - 2) + (float)game->getState(game->getSize() - 3) / 2) -
+               ((float)game->getState(game->getSize() / 2 - 2) + (float)game->getState(game->getSize() / 2 - 3) / 2) / 2;
+    return Player == 1 ? utility : -utility;
+}
+
+/*
+True when it is Player's turn.
+*/
+template <int Player>
+bool maxLayer(ABSearchableState<DefaultMancala::board_t, action_t> *state)
+{
+    return ((DefaultMancala *)state)->getTurn() == Player;
+}
@@ -0,0 +1,265 @@
+#pragma once
+#include "MancalaTablebase.h"
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+Constructor
+Maps the tablebase file at path read-only.
+Throws runtime_error if the file can't be read or is not a tablebase.
+*/
+MancalaTablebase::MancalaTablebase(const std::string &path) : MancalaTablebase(path, readHeader(path)) {}
+
+MancalaTablebase::MancalaTablebase(const std::string &path, const Header &header)
+    : pitsPerSide{header.pitsPerSide}, maxStones{header.maxStones}, index(pitsPerSide, maxStones)
+{
+    if (header.entries != index.size())
+        throw std::runtime_error("corrupt tablebase " + path);
+    int file = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0)
+    {
+        if (file >= 0)
+            close(file);
+        throw std::runtime_error("cannot open tablebase " + path);
+    }
+    mappingSize = sizeof(Header) + header.entries;
+    if ((size_t)status.st_size != mappingSize)
+    {
+        close(file);
+        throw std::runtime_error("corrupt tablebase " + path);
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, file, 0);
+    close(file); //the mapping keeps the file open
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        throw std::runtime_error("cannot map tablebase " + path);
+    }
+    madvise(mapping, mappingSize, MADV_RANDOM); //probes jump around, skip readahead
+    values = (const int8_t *)mapping + sizeof(Header);
+}
+
+MancalaTablebase::~MancalaTablebase()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+/*
+Reads and checks the header of the tablebase file at path.
+*/
+MancalaTablebase::Header MancalaTablebase::readHeader(const std::string &path)
+{
+    Header header;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read((char *)&header, sizeof(header)))
+        throw std::runtime_error("cannot read tablebase " + path);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.pitsPerSide == 0 ||
+        header.maxStones > MAX_TABLEBASE_STONES)
+        throw std::runtime_error(path + " is not a Mancala tablebase");
+    return header;
+}
+
+/*
+Looks up the position on a board with turn to move.  On success sets value
+to the number of stones left in the pits that the player to move wins over
+the opponent with perfect play, and returns true.
+Returns false if the board has the wrong size or too many stones in play.
+*/
+template <class Board>
+bool MancalaTablebase::probe(const Board &state, short turn, int &value) const
+{
+    if (state.size() != pitsPerSide * 2 + 2)
+        return false;
+    unsigned int stones = 0;
+    for (size_t i = 0; i < pitsPerSide; i++)
+        stones += state[i] + state[pitsPerSide + 1 + i];
+    if (stones > maxStones)
+        return false;
+    value = values[index(state, turn, stones)];
+    return true;
+}
+
+/*
+Solves every position with up to maxStones stones in play on a board with
+pitsPerSide pits a side and writes the tablebase to path.
+M is the Mancala board type whose rules are used (BasicMancala with room for
+pitsPerSide pits a side).  verbose prints progress for each layer.
+Throws invalid_argument for unsupported sizes and runtime_error if path
+can't be written.
+*/
+template <class M>
+void MancalaTablebase::generate(const std::string &path, size_t pitsPerSide, unsigned int maxStones, bool verbose)
+{
+    if (maxStones > MAX_TABLEBASE_STONES)
+        throw std::invalid_argument("tablebases cover at most " + std::to_string(MAX_TABLEBASE_STONES) + " stones");
+    Index index(pitsPerSide, maxStones);
+    std::vector<int8_t> values(index.size(), Solver<M>::UNSOLVED);
+    Solver<M> solver(index, pitsPerSide, values);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int stones = 0; stones <= maxStones; stones++)
+    {
+        solver.solveLayer(stones);
+        if (verbose)
+            printf("%3u stones: %12llu positions  %8.1fs\n", stones,
+                   (unsigned long long)(index.layer(stones + 1) - index.layer(stones)),
+                   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.pitsPerSide = pitsPerSide;
+    header.maxStones = maxStones;
+    header.entries = values.size();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)values.data(), values.size());
+    if (!file)
+        throw std::runtime_error("cannot write tablebase " + path);
+}
+
+/*
+Constructor
+*/
+MancalaTablebase::Index::Index(size_t pitsPerSide, unsigned int maxStones)
+    : pitsPerSide{pitsPerSide}, pits{pitsPerSide * 2}, maxStones{maxStones}
+{
+    //Pascal's triangle, up to the last layer's size
+    size_t rows = maxStones + pits + 1;
+    binomials.assign(rows * (pits + 1), 0);
+    for (size_t n = 0; n < rows; n++)
+    {
+        binomials[n * (pits + 1)] = 1;
+        for (size_t k = 1; k <= pits && k <= n; k++)
+            binomials[n * (pits + 1) + k] = choose(n - 1, k - 1) + choose(n - 1, k);
+    }
+}
+
+/*
+Position of a board with turn to move and stones in play.
+The layers of fewer stones come first.  Within a layer, for the pits in order
+from the mover's first pit, every way to fill the rest of the pits after a
+smaller count in this pit comes first.
+*/
+template <class Board>
+uint64_t MancalaTablebase::Index::operator()(const Board &state, short turn, unsigned int stones) const
+{
+    size_t size = pits + 2, first = turn == 1 ? 0 : pitsPerSide + 1;
+    uint64_t rank = layer(stones);
+    unsigned int left = stones;
+    for (size_t i = 0; i + 1 < pits && left > 0; i++)
+    {
+        //Ways to put left - count stones, for each smaller count, into the remaining pits
+        size_t rest = pits - i - 1;
+        unsigned int count = state[(first + i + (i >= pitsPerSide)) % size]; //skip the mover's store
+        rank += choose(left + rest, rest) - choose(left - count + rest, rest);
+        left -= count;
+    }
+    return rank;
+}
+
+/*
+Backward induction over the positions of a tablebase, using M for the rules.
+*/
+template <class M>
+class MancalaTablebase::Solver
+{
+public:
+    static constexpr int8_t UNSOLVED = INT8_MIN;
+
+    Solver(const Index &index, size_t pitsPerSide, std::vector<int8_t> &values)
+        : index{index}, pitsPerSide{pitsPerSide}, values{values} {};
+
+    /*
+    Solves every position with stones in play.  Layers with fewer stones
+    must be solved already.
+    */
+    void solveLayer(unsigned int stones)
+    {
+        board_t board = M(pitsPerSide, 1).getBoard();
+        for (auto &pit : board)
+            pit = 0;
+        enumerate(board, 0, stones, stones);
+    };
+
+private:
+    typedef typename M::board_t board_t;
+
+    const Index &index;
+    size_t pitsPerSide;
+    std::vector<int8_t> &values;
+
+    /*
+    Solves every position with left stones spread over pits pit onwards
+    (counted along player 1's path, skipping their store).
+    */
+    void enumerate(board_t &board, size_t pit, unsigned int left, unsigned int stones)
+    {
+        size_t square = pit + (pit >= pitsPerSide);
+        if (pit == pitsPerSide * 2 - 1)
+        {
+            board[square] = left;
+            solve(board, 1, stones);
+            board[square] = 0;
+            return;
+        }
+        for (unsigned int count = 0; count <= left; count++)
+        {
+            board[square] = count;
+            enumerate(board, pit + 1, left - count, stones);
+        }
+        board[square] = 0;
+    };
+
+    /*
+    Value of a position (empty stores) for turn, solving it and the positions
+    it leads to with as many stones in play first if needed.
+    */
+    int solve(const board_t &board, short turn, unsigned int stones)
+    {
+        uint64_t position = index(board, turn, stones);
+        if (values[position] != UNSOLVED)
+            return values[position];
+        size_t first = turn == 1 ? 0 : pitsPerSide + 1, other = turn == 1 ? pitsPerSide + 1 : 0;
+        int mover = 0, opponent = 0;
+        for (size_t i = 0; i < pitsPerSide; i++)
+        {
+            mover += board[first + i];
+            opponent += board[other + i];
+        }
+        int value = INT_MIN;
+        if (mover == 0 || opponent == 0)
+            value = mover - opponent; //swept into the stores
+        else
+        {
+            M game(board, turn);
+            ActionList<typename M::action_type> moves;
+            game.getValidMoves(moves);
+            for (auto move : moves)
+            {
+                game.makeMove(move);
+                int player1 = game.getPlayer1Score(), player2 = game.getPlayer2Score();
+                int moveValue = turn == 1 ? player1 - player2 : player2 - player1;
+                if (game.getWinner() < 0)
+                {
+                    board_t child = game.getBoard();
+                    child[pitsPerSide] = child[pitsPerSide * 2 + 1] = 0;
+                    int rest = solve(child, game.getTurn(), stones - player1 - player2);
+                    moveValue += game.getTurn() == turn ? rest : -rest;
+                }
+                value = std::max(value, moveValue);
+                game.undoMove();
+            }
+        }
+        values[position] = value;
+        return value;
+    };
+};
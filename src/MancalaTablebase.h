@@ -0,0 +1,100 @@
+#pragma once
+/*
+Endgame tablebase for Mancala.
+Holds the result of perfect play for every position with up to maxStones
+stones left in the pits: how many more of those stones the player to move
+ends up with in their store than the opponent does.  The stores themselves
+never change how the rest of the game is played, so they are not part of a
+position.
+
+Positions are indexed by a perfect hash.  The pits are read starting with the
+first pit of the player to move, and the positions with n stones in play form
+layer n: every way of spreading n stones over the pits, ranked in the
+combinatorial number system.  The file is a short header followed by one
+signed byte per position.
+
+generate() solves the table offline by backward induction, one layer at a
+time from the fewest stones up.  A move never adds stones to the pits, and a
+move that leaves every stone in play only moves stones towards the mover's
+store, so each layer only depends on itself without cycles and on the layers
+already solved.
+A loaded table is memory-mapped read-only, so every process probing the same
+file shares one copy of it in the page cache.
+*/
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Defaults
+const unsigned int DEFAULT_TABLEBASE_STONES = 12; //stones in play covered by generate()
+const unsigned int MAX_TABLEBASE_STONES = 127;    //most an entry's value can count
+
+class MancalaTablebase
+{
+public:
+    //construct/destruct
+    MancalaTablebase(const std::string &path);
+    ~MancalaTablebase();
+    MancalaTablebase(const MancalaTablebase &) = delete;
+    MancalaTablebase &operator=(const MancalaTablebase &) = delete;
+
+    template <class M>
+    static void generate(const std::string &path, size_t pitsPerSide,
+                         unsigned int maxStones = DEFAULT_TABLEBASE_STONES, bool verbose = false);
+
+    template <class Board>
+    bool probe(const Board &state, short turn, int &value) const;
+
+    //getters
+    size_t getPitsPerSide() const { return pitsPerSide; };
+    unsigned int getMaxStones() const { return maxStones; };
+    size_t getEntryCount() const { return index.size(); };
+
+private:
+    static constexpr char MAGIC[8] = {'M', 'A', 'N', 'C', 'T', 'B', '0', '1'};
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t pitsPerSide;
+        uint32_t maxStones;
+        uint64_t entries;
+        uint64_t reserved;
+    };
+
+    /*
+    Perfect hash of the positions with up to maxStones stones in play.
+    */
+    class Index
+    {
+    public:
+        Index(size_t pitsPerSide, unsigned int maxStones);
+
+        template <class Board>
+        uint64_t operator()(const Board &state, short turn, unsigned int stones) const;
+        uint64_t size() const { return layer(maxStones + 1); };
+        uint64_t layer(unsigned int stones) const { return choose(stones + pits - 1, pits); };
+
+    private:
+        size_t pitsPerSide, pits;
+        unsigned int maxStones;
+        std::vector<uint64_t> binomials; //n choose k at n * (pits + 1) + k
+
+        uint64_t choose(size_t n, size_t k) const { return binomials[n * (pits + 1) + k]; };
+    };
+
+    template <class M>
+    class Solver;
+
+    size_t pitsPerSide;
+    unsigned int maxStones;
+    Index index;
+    void *mapping = nullptr; //whole file, read-only
+    size_t mappingSize = 0;
+    const int8_t *values = nullptr;
+
+    MancalaTablebase(const std::string &path, const Header &header);
+    static Header readHeader(const std::string &path);
+};
+
+#include "MancalaTablebase.cpp"
@@ -0,0 +1,62 @@
+#pragma once
+/*
+Move ordering for alpha-beta searches.
+Children are searched best first: the principal variation or table move,
+then moves the game hints at (ABSearchableState::actionHint()), then killer
+moves (moves that caused a cutoff at the same ply), then by history (how
+much a move has caused cutoffs anywhere in the search).
+History is keyed by ABSearchableState::actionId(), which names a move the
+same way in every position, so one MoveOrdering works for any action type.
+Keep one per search thread; it is reused across iterative deepening iterations.
+*/
+#include <algorithm>
+#include <vector>
+#include "ActionList.h"
+
+/*
+Which ordering heuristics to use.  All off searches children in generation order.
+*/
+struct OrderingOptions
+{
+    bool tableMove = true; //principal variation / transposition table move first
+    bool hints = true;     //game provided hints
+    bool killers = false;  //killer moves per ply (help Checkers, but cost Mancala nodes)
+    bool history = true;   //history heuristic
+};
+
+template <class A>
+class MoveOrdering
+{
+public:
+    //construct/destruct
+    MoveOrdering(const OrderingOptions &options = OrderingOptions()) : options{options} {};
+
+    void newSearch();
+    void order(const ActionList<A> &actions, const int *hints, const unsigned int *ids, unsigned int ply,
+               unsigned int side, unsigned int firstMove, unsigned int *indices);
+    void cutoff(const A &action, unsigned int id, unsigned int ply, unsigned int side, unsigned int depth);
+
+    //getters
+    const OrderingOptions &getOptions() const { return options; };
+
+private:
+    static constexpr unsigned int KILLERS = 2; //killer moves kept per ply
+    static const int FIRST_SCORE = 1 << 30;
+    static const int HINT_SCORE = 1 << 24;   //per hint point, hints are capped at 15
+    static const int KILLER_SCORE = 1 << 21; //halved for the second killer
+    static const unsigned int HISTORY_MAX = 1 << 20;
+
+    struct Killers
+    {
+        A moves[KILLERS];
+        unsigned int count = 0;
+    };
+
+    OrderingOptions options;
+    std::vector<Killers> killers;             //indexed by ply
+    unsigned int history[2][MAX_ACTION_IDS] = {}; //[side][actionId()]
+
+    void ageHistory();
+};
+
+#include "MoveOrdering.tpp"
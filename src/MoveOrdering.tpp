@@ -0,0 +1,87 @@
+#pragma once
+#include "MoveOrdering.h"
+
+/*
+Prepares for the next search.  Killers stay (plies line up between
+iterations), history is aged so recent cutoffs count most.
+*/
+template <class A>
+void MoveOrdering<A>::newSearch()
+{
+    ageHistory();
+}
+
+/*
+Writes the positions of actions to indices, best first.
+hints holds actionHint() and ids actionId() for each action (nullptr if not
+used), side is 0 in maximizing layers and 1 in minimizing ones, and firstMove is the position of
+the principal variation or table move (NO_MOVE_INDEX if none).
+*/
+template <class A>
+void MoveOrdering<A>::order(const ActionList<A> &actions, const int *hints, const unsigned int *ids,
+                            unsigned int ply, unsigned int side, unsigned int firstMove, unsigned int *indices)
+{
+    int scores[MAX_ACTIONS];
+    const Killers *plyKillers = options.killers && ply < killers.size() ? &killers[ply] : nullptr;
+    for (unsigned int i = 0; i < actions.size(); i++)
+    {
+        int score = 0;
+        if (options.tableMove && i == firstMove)
+            score += FIRST_SCORE;
+        if (hints && hints[i] > 0)
+            score += HINT_SCORE * std::min(hints[i], 15);
+        if (plyKillers)
+            for (unsigned int k = 0; k < plyKillers->count; k++)
+                if (plyKillers->moves[k] == actions[i])
+                    score += KILLER_SCORE >> k;
+        if (options.history && ids && ids[i] < MAX_ACTION_IDS)
+            score += history[side][ids[i]];
+        scores[i] = score;
+        //Insertion sort, stable so ties keep generation order
+        unsigned int j = i;
+        for (; j > 0 && scores[indices[j - 1]] < score; j--)
+            indices[j] = indices[j - 1];
+        indices[j] = i;
+    }
+}
+
+/*
+Records that action (with actionId() id) caused a cutoff at ply with depth
+remaining.
+*/
+template <class A>
+void MoveOrdering<A>::cutoff(const A &action, unsigned int id, unsigned int ply, unsigned int side,
+                             unsigned int depth)
+{
+    if (options.killers)
+    {
+        if (ply >= killers.size())
+            killers.resize(ply + 1);
+        Killers &plyKillers = killers[ply];
+        if (plyKillers.count == 0 || !(plyKillers.moves[0] == action))
+        {
+            //Newest killer first
+            for (unsigned int k = KILLERS - 1; k > 0; k--)
+                plyKillers.moves[k] = plyKillers.moves[k - 1];
+            plyKillers.moves[0] = action;
+            plyKillers.count = std::min(plyKillers.count + 1, KILLERS);
+        }
+    }
+    if (options.history && id < MAX_ACTION_IDS)
+    {
+        history[side][id] += depth * depth;
+        if (history[side][id] >= HISTORY_MAX)
+            ageHistory();
+    }
+}
+
+/*
+Halves every history score.
+*/
+template <class A>
+void MoveOrdering<A>::ageHistory()
+{
+    for (auto &sideHistory : history)
+        for (auto &score : sideHistory)
+            score /= 2;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "SearchControl.h"
+
+/*
+Calls stop() once deadline passes.  Replaces any earlier deadline.
+*/
+void SearchControl::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    Watcher &timer = watcher();
+    std::lock_guard<std::mutex> guard(timer.lock);
+    if (hasDeadline)
+        timer.deadlines.erase(deadlineEntry);
+    deadlineEntry = timer.deadlines.emplace(deadline, this);
+    hasDeadline = true;
+    timer.changed.notify_one();
+}
+
+/*
+Removes the deadline, if any.
+*/
+void SearchControl::clearDeadline()
+{
+    if (!hasDeadline)
+        return;
+    Watcher &timer = watcher();
+    std::lock_guard<std::mutex> guard(timer.lock);
+    if (hasDeadline) //may have fired meanwhile
+        timer.deadlines.erase(deadlineEntry);
+    hasDeadline = false;
+}
+
+/*
+Makes the control reusable for another search.
+*/
+void SearchControl::reset()
+{
+    clearDeadline();
+    stopFlag.store(false, std::memory_order_relaxed);
+    nodeCount.store(0, std::memory_order_relaxed);
+}
+
+/*
+Called by a search every few nodes with the number of nodes searched since
+its last call.  Stops the control once the node limit is reached (so the
+limit is only kept to within checkInterval nodes per search thread).
+Returns stopped().
+*/
+bool SearchControl::poll(size_t nodes)
+{
+    if (nodeLimit && nodeCount.fetch_add(nodes, std::memory_order_relaxed) + nodes >= nodeLimit)
+        stop();
+    return stopped();
+}
+
+/*
+Returns the watcher shared by every control, started on first use.
+*/
+SearchControl::Watcher &SearchControl::watcher()
+{
+    static Watcher timer;
+    return timer;
+}
+
+SearchControl::Watcher::Watcher()
+{
+    thread = std::thread(&Watcher::run, this);
+}
+
+SearchControl::Watcher::~Watcher()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    changed.notify_one();
+    thread.join();
+}
+
+/*
+Sleeps until the earliest deadline, stops its control, repeats.
+*/
+void SearchControl::Watcher::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (!stopping)
+    {
+        if (deadlines.empty())
+        {
+            changed.wait(guard);
+            continue;
+        }
+        auto earliest = deadlines.begin();
+        if (std::chrono::steady_clock::now() < earliest->first)
+        {
+            changed.wait_until(guard, earliest->first);
+            continue; //deadlines may have changed
+        }
+        earliest->second->stop();
+        earliest->second->hasDeadline = false;
+        deadlines.erase(earliest);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+/*
+Cooperative cancellation for searches.
+A search polls the control every checkInterval nodes instead of reading the
+clock at every node.  The flag is set by stop(), from any thread, by a
+single watcher thread shared by all controls once a deadline passes, or
+once the searches polling the control have searched a node limit.
+*/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//Defaults
+const unsigned int DEFAULT_CHECK_INTERVAL = 1024; //nodes searched between stop checks
+
+class SearchControl
+{
+public:
+    //construct/destruct
+    SearchControl(unsigned int checkInterval = DEFAULT_CHECK_INTERVAL)
+        : checkInterval{checkInterval ? checkInterval : 1} {};
+    ~SearchControl() { clearDeadline(); };
+
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    void clearDeadline();
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); };
+    void reset();
+    void setNodeLimit(size_t nodes) { nodeLimit = nodes; }; //0 = no limit
+    bool poll(size_t nodes);
+
+    //getters
+    bool stopped() const { return stopFlag.load(std::memory_order_relaxed); };
+    unsigned int getCheckInterval() const { return checkInterval; };
+
+private:
+    std::atomic<bool> stopFlag{false};
+    unsigned int checkInterval;
+    size_t nodeLimit = 0;
+    std::atomic<size_t> nodeCount{0}; //nodes reported by poll()
+    std::atomic<bool> hasDeadline{false}; //written under the watcher lock
+    std::multimap<std::chrono::steady_clock::time_point, SearchControl *>::iterator deadlineEntry;
+
+    /*
+    Thread that stops controls when their deadlines pass.
+    */
+    class Watcher
+    {
+    public:
+        Watcher();
+        ~Watcher();
+        std::mutex lock;
+        std::condition_variable changed;
+        std::multimap<std::chrono::steady_clock::time_point, SearchControl *> deadlines;
+
+    private:
+        bool stopping = false;
+        std::thread thread;
+        void run();
+    };
+    static Watcher &watcher();
+};
+
+#include "SearchControl.cpp"
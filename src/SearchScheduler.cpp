@@ -0,0 +1,113 @@
+#pragma once
+#include "SearchScheduler.h"
+
+/*
+Constructor
+Starts a pool of threads workers; jobs run on them, never on the caller.
+*/
+SearchScheduler::SearchScheduler(unsigned int threads)
+    : threads{threads ? threads : std::max(1u, std::thread::hardware_concurrency())},
+      freeThreads{this->threads}, pool(this->threads)
+{
+}
+
+/*
+Queues job to run once threads are free and the jobs with earlier deadlines
+have started.
+*/
+void SearchScheduler::submit(std::chrono::steady_clock::time_point deadline, Job job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    queue.push({deadline, nextSequence++, std::move(job)});
+    dispatch();
+}
+
+/*
+Blocks until no job is queued or running.
+*/
+void SearchScheduler::wait()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [this]
+                  { return queue.empty() && running.empty(); });
+}
+
+size_t SearchScheduler::getQueued()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return queue.size();
+}
+
+size_t SearchScheduler::getRunning()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return running.size();
+}
+
+unsigned int SearchScheduler::getBusyThreads()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return threads - freeThreads;
+}
+
+/*
+Starts queued jobs, earliest deadline first, while threads are free.
+Each takes its share of the free threads rounded up, so earlier deadlines
+get the larger shares.  Then paces the running jobs for the ones still
+waiting.  Called with lock held.
+*/
+void SearchScheduler::dispatch()
+{
+    while (freeThreads > 0 && !queue.empty())
+    {
+        unsigned int waiting = queue.size();
+        unsigned int share = (freeThreads + waiting - 1) / waiting;
+        auto job = running.emplace(running.end());
+        job->deadline = queue.top().deadline;
+        Job work = std::move(const_cast<Request &>(queue.top()).job); //popped right away
+        queue.pop();
+        freeThreads -= share;
+        pace(); //sets the new job's deadline before it starts
+        //The pool has a worker for this job and one for each of its helpers
+        pool.submit([this, share, job, work = std::move(work)]
+                    {
+                        work(share, pool, job->control);
+                        finish(share, job); });
+    }
+    pace();
+}
+
+/*
+Moves the running jobs' finishing times earlier if jobs are waiting: each
+is to finish after the time left to its deadline divided by the rounds of
+waiting jobs (threads at a time) plus its own, so the jobs behind it get as
+long.  Finishing times are never moved later.  Called with lock held.
+*/
+void SearchScheduler::pace()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    long rounds = 1 + queue.size() / threads;
+    for (Running &job : running)
+    {
+        std::chrono::steady_clock::time_point finishBy =
+            job.deadline > now ? now + (job.deadline - now) / rounds : job.deadline;
+        if (finishBy < job.finishBy)
+        {
+            job.finishBy = finishBy;
+            job.control.setDeadline(finishBy);
+        }
+    }
+}
+
+/*
+Returns a finished job's threads and starts the jobs waiting for them.
+*/
+void SearchScheduler::finish(unsigned int share, std::list<Running>::iterator job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    running.erase(job);
+    freeThreads += share;
+    dispatch();
+    if (queue.empty() && running.empty())
+        finished.notify_all();
+}
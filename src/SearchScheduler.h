@@ -0,0 +1,90 @@
+#pragma once
+/*
+Shares one fixed set of threads between many searches, e.g. the bot moves
+of every game a server hosts, instead of each search starting
+hardware_concurrency() threads of its own and all of them together
+oversubscribing the machine.
+Searches are submitted as jobs with a deadline and started earliest deadline
+first.  Each is given the rounded up even share of the threads free at the
+time among the jobs waiting (at least one) and keeps them until it returns,
+so the jobs running never use more threads than the scheduler has.  A job
+runs on one of its threads and gets the others from the scheduler's pool,
+e.g. as SearchOptions::threads and SearchOptions::pool for Bot::search().
+Each job gets a SearchControl to search through (SearchOptions::control)
+whose deadline is the time to finish by: the time left to its deadline,
+divided by the rounds of jobs waiting for threads behind it.  It is moved
+earlier as more jobs queue up, so a burst of requests is worked off with
+shorter searches instead of the jobs at the back all missing their
+deadlines.  Jobs that had to wait get no extra time.
+*/
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "SearchControl.h"
+#include "ThreadPool.h"
+
+class SearchScheduler
+{
+public:
+    typedef std::function<void(unsigned int threads, ThreadPool &pool, SearchControl &control)>
+        Job; //must not throw
+
+    //construct/destruct
+    SearchScheduler(unsigned int threads = 0); //0 = hardware_concurrency()
+    ~SearchScheduler() { wait(); };
+    SearchScheduler(const SearchScheduler &) = delete;
+    SearchScheduler &operator=(const SearchScheduler &) = delete;
+
+    void submit(std::chrono::steady_clock::time_point deadline, Job job);
+    void wait(); //until every job submitted has finished
+
+    //getters
+    unsigned int getThreads() const { return threads; };
+    size_t getQueued();
+    size_t getRunning();
+    unsigned int getBusyThreads();
+
+private:
+    struct Request
+    {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t sequence; //first come first served between equal deadlines
+        Job job;
+
+        bool operator>(const Request &other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        };
+    };
+
+    /*
+    A job that has started.
+    */
+    struct Running
+    {
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point finishBy = std::chrono::steady_clock::time_point::max();
+        SearchControl control;
+    };
+
+    unsigned int threads;
+    unsigned int freeThreads;
+    std::mutex lock;
+    std::condition_variable finished;
+    std::priority_queue<Request, std::vector<Request>, std::greater<Request>> queue; //earliest deadline on top
+    uint64_t nextSequence = 0;
+    std::list<Running> running;
+    ThreadPool pool; //last, so its workers stop before the rest is destroyed
+
+    void dispatch();
+    void pace();
+    void finish(unsigned int share, std::list<Running>::iterator job);
+};
+
+#include "SearchScheduler.cpp"
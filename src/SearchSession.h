@@ -0,0 +1,72 @@
+#pragma once
+/*
+A bot's search state kept for a whole game.
+Every search() shares one transposition table, and the best line of the last
+search is kept, so each move starts from the work done for the previous one.
+While the opponent thinks, ponder() searches the position the best line
+expects them to move to on a background thread.  If they play the expected
+move, the next search() continues the ponder search with a fresh thinkTime
+(a ponder hit), so it searches deeper in the same wait.  Otherwise the ponder
+search is stopped and a normal search starts, still with the shared table.
+Unless options.pool is given, the session's helper threads come from a pool
+of its own, so other searches can't take them.
+search() and ponder() must be called from one thread.
+*/
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <thread>
+#include "Bot.h"
+
+template <class S, class A>
+class SearchSession
+{
+public:
+    //construct/destruct
+    SearchSession(float (*utilityFunction)(ABSearchableState<S, A> *),
+                  bool (*maxLayerFunction)(ABSearchableState<S, A> *) = nullptr,
+                  unsigned int searchDepth = DEFAULT_DEPTH,
+                  std::chrono::milliseconds thinkTime = DEFAULT_TIME,
+                  const SearchOptions &options = SearchOptions(),
+                  size_t megabytes = DEFAULT_TABLE_MB);
+    ~SearchSession() { stopPondering(); };
+    SearchSession(const SearchSession &) = delete;
+    SearchSession &operator=(const SearchSession &) = delete;
+
+    SearchResult<A> search(ABSearchableState<S, A> *state);
+    A getMove(ABSearchableState<S, A> *state) { return search(state).move; };
+    bool ponder(ABSearchableState<S, A> *state);
+    void stopPondering();
+
+    //getters/setters
+    bool isPondering() const { return ponderThread.joinable(); };
+    const SearchResult<A> &getLastResult() const { return lastResult; };
+    size_t getPonderHits() const { return ponderHits; };
+    size_t getPonderMisses() const { return ponderMisses; };
+    void setThinkTime(std::chrono::milliseconds time) { thinkTime = time; };
+    void clear(); //forgets earlier searches (e.g. for a new game)
+
+private:
+    float (*utilityFunction)(ABSearchableState<S, A> *);
+    bool (*maxLayerFunction)(ABSearchableState<S, A> *);
+    unsigned int searchDepth;
+    std::chrono::milliseconds thinkTime;
+    SearchOptions options;
+    std::unique_ptr<ThreadPool> pool; //helper threads, unless options.pool was given
+    TranspositionTable table;
+    SearchResult<A> lastResult;
+    size_t lastMoveHash = 0; //hash of the position after lastResult.move
+    size_t ponderHits = 0, ponderMisses = 0;
+
+    //Ponder search, running while ponderThread is joinable
+    std::thread ponderThread;
+    std::unique_ptr<ABSearchableState<S, A>> ponderPosition;
+    size_t ponderHash = 0;
+    std::unique_ptr<SearchControl> ponderControl;
+    SearchResult<A> ponderResult;
+    std::exception_ptr ponderError;
+
+    void remember(ABSearchableState<S, A> *state, const SearchResult<A> &result);
+};
+
+#include "SearchSession.tpp"
@@ -0,0 +1,137 @@
+#pragma once
+#include "SearchSession.h"
+
+/*
+Constructor
+Arguments are as for Bot::search(); megabytes sizes the session's table.
+*/
+template <class S, class A>
+SearchSession<S, A>::SearchSession(float (*utilityFunction)(ABSearchableState<S, A> *),
+                                   bool (*maxLayerFunction)(ABSearchableState<S, A> *),
+                                   unsigned int searchDepth, std::chrono::milliseconds thinkTime,
+                                   const SearchOptions &options, size_t megabytes)
+    : utilityFunction{utilityFunction}, maxLayerFunction{maxLayerFunction}, searchDepth{searchDepth},
+      thinkTime{thinkTime}, options{options}, table(megabytes)
+{
+    this->options.control = nullptr; //the session brings its own for pondering
+    if (!options.pool && options.threads != 1)
+    {
+        pool.reset(new ThreadPool(options.threads ? options.threads - 1 : 0));
+        this->options.pool = pool.get();
+    }
+}
+
+/*
+Searches state for thinkTime, like Bot::search().  If state is the position
+being pondered, the ponder search is given thinkTime more and its result is
+returned instead.
+Throws ABTimeout if no move was found in time.
+*/
+template <class S, class A>
+SearchResult<A> SearchSession<S, A>::search(ABSearchableState<S, A> *state)
+{
+    SearchResult<A> result;
+    if (isPondering() && state->hash() == ponderHash)
+    {
+        ponderHits++;
+        ponderControl->setDeadline(std::chrono::steady_clock::now() + thinkTime);
+        ponderThread.join();
+        ponderControl.reset();
+        ponderPosition.reset();
+        if (ponderError)
+            std::rethrow_exception(ponderError);
+        result = ponderResult;
+    }
+    else
+    {
+        if (isPondering())
+            ponderMisses++;
+        stopPondering();
+        result = Bot<S, A>::search(state, utilityFunction, searchDepth, thinkTime, DEFAULT_PRECISION,
+                                   maxLayerFunction, &table, options);
+    }
+    remember(state, result);
+    return result;
+}
+
+/*
+Starts searching, in the background, the position the last search's best
+line expects after the opponent replies to its move.  state is the current
+position, which must be the one after that move.
+With a maxLayerFunction, the line is followed until it is the maximizing
+side's turn again (for games with extra turns).
+The ponder search runs until the next search() or stopPondering().
+Returns false if there is no expected reply to ponder on.
+*/
+template <class S, class A>
+bool SearchSession<S, A>::ponder(ABSearchableState<S, A> *state)
+{
+    stopPondering();
+    if (lastResult.pv.size() < 2 || state->hash() != lastMoveHash || state->isABTerminalState())
+        return false;
+    std::unique_ptr<ABSearchableState<S, A>> position(state->clone());
+    size_t next = 1;
+    do
+        position->doAction(lastResult.pv[next++]);
+    while (maxLayerFunction && !maxLayerFunction(position.get()) && next < lastResult.pv.size() &&
+           !position->isABTerminalState());
+    if (position->isABTerminalState() || (maxLayerFunction && !maxLayerFunction(position.get())))
+        return false;
+
+    ponderPosition = std::move(position);
+    ponderHash = ponderPosition->hash();
+    ponderControl.reset(new SearchControl(options.checkInterval));
+    ponderError = nullptr;
+    SearchOptions ponderOptions = options;
+    ponderOptions.control = ponderControl.get(); //no deadline until a ponder hit
+    ponderThread = std::thread([this, ponderOptions]
+                               {
+        try
+        {
+            ponderResult = Bot<S, A>::search(ponderPosition.get(), utilityFunction, searchDepth, thinkTime,
+                                             DEFAULT_PRECISION, maxLayerFunction, &table, ponderOptions);
+        }
+        catch (...)
+        {
+            ponderError = std::current_exception();
+        } });
+    return true;
+}
+
+/*
+Stops and discards the ponder search, if any.
+*/
+template <class S, class A>
+void SearchSession<S, A>::stopPondering()
+{
+    if (!isPondering())
+        return;
+    ponderControl->stop();
+    ponderThread.join();
+    ponderControl.reset();
+    ponderPosition.reset();
+}
+
+/*
+Forgets the table and best line.
+*/
+template <class S, class A>
+void SearchSession<S, A>::clear()
+{
+    stopPondering();
+    table.clear();
+    lastResult = SearchResult<A>();
+    lastMoveHash = 0;
+}
+
+/*
+Keeps result as the best line from state.
+*/
+template <class S, class A>
+void SearchSession<S, A>::remember(ABSearchableState<S, A> *state, const SearchResult<A> &result)
+{
+    lastResult = result;
+    std::unique_ptr<ABSearchableState<S, A>> after(state->clone());
+    after->doAction(result.move);
+    lastMoveHash = after->hash();
+}
@@ -0,0 +1,154 @@
+#pragma once
+/*
+Exact solver: the game-theoretic value of a position, found by searching
+every line to the end of the game instead of to a depth or time limit.
+Meant for small configurations (e.g. Mancala(4, 3)) that can be solved
+outright, possibly over hours.
+
+Each root child is solved with MTD(f): a series of null-window alpha-beta
+searches that each only prove a bound ("the value is at least t" or "at most
+t") and move the window towards the value until the bounds meet.  Every
+bound proven is kept in a large transposition table, so later searches of
+the series reuse almost all of the earlier ones.  Searches to the end of the
+game never go stale, so table entries are used whatever depth they were
+stored with; the depth field instead holds the size of the proof (the bit
+length of its node count), so the table keeps the proofs that took longest.
+
+Progress (nodes, proven positions and the current bounds) is reported every
+progressInterval.  With a checkpoint path, the table and the root children
+solved so far are written to disk every checkpointInterval and when the
+solve is stopped, and a later solve of the same position with resume set
+continues from there.
+
+G, E and P are as for StaticSearch.  Values are whole game results from the
+evaluator, so every line has to reach a terminal position (or one settled by
+resolveExact()).
+*/
+#include <chrono>
+#include <cfloat>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ActionList.h"
+#include "MoveOrdering.h"
+#include "SearchControl.h"
+#include "StaticSearch.h"
+#include "TranspositionTable.h"
+
+//Defaults
+const size_t DEFAULT_SOLVER_TABLE_MB = 1024;
+const std::chrono::seconds DEFAULT_CHECKPOINT_INTERVAL = std::chrono::seconds(600);
+const std::chrono::seconds DEFAULT_PROGRESS_INTERVAL = std::chrono::seconds(10);
+const unsigned int SOLVER_CHECK_INTERVAL = 4096; //nodes between progress, checkpoint and stop checks
+
+/*
+Where a solve has got to.
+*/
+struct SolveProgress
+{
+    size_t nodes = 0;           //positions searched
+    size_t proven = 0;          //positions whose value or bound was proven and stored
+    double seconds = 0;         //wall time, including earlier runs resumed from
+    unsigned int move = 0;      //root child being solved
+    unsigned int moves = 0;     //root children
+    float lower = FLT_MAX * -1; //bounds proven so far on that child's value
+    float upper = FLT_MAX;
+    unsigned int iterations = 0; //null-window searches, over all root children
+
+    double nodesPerSecond() const { return seconds > 0 ? nodes / seconds : 0; };
+    double provenPerSecond() const { return seconds > 0 ? proven / seconds : 0; };
+};
+
+/*
+Solver settings.
+*/
+struct SolveOptions
+{
+    size_t megabytes = DEFAULT_SOLVER_TABLE_MB; //transposition table size
+    std::string checkpointPath;                 //file for checkpoints ("" for none)
+    bool resume = false;                        //continue from checkpointPath if it exists
+    std::chrono::seconds checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL;
+    std::chrono::seconds progressInterval = DEFAULT_PROGRESS_INTERVAL;
+    std::function<void(const SolveProgress &)> progress; //called every progressInterval (if set)
+    SearchControl *control = nullptr;                    //stops the solve (e.g. by deadline or node limit)
+};
+
+/*
+Outcome of a solve.  Values are for the root's maximizing side.
+*/
+template <class A>
+struct SolveResult
+{
+    bool complete = false;     //false if stopped before every root child was solved
+    float value = 0;           //value of the root with perfect play
+    A move{};                  //a move that achieves it
+    std::vector<A> moves;      //root children solved, in generateActions() order
+    std::vector<float> values; //their values
+    SolveProgress progress;
+};
+
+template <class G, class E, class P = AlternatingLayers>
+class Solver
+{
+public:
+    typedef typename G::action_type A;
+
+    //construct/destruct
+    Solver(const E &evaluator = E(), const P &policy = P(), const SolveOptions &options = SolveOptions());
+    Solver(const Solver &) = delete;
+    Solver &operator=(const Solver &) = delete;
+
+    SolveResult<A> solve(G *rootState);
+
+    //getters
+    TranspositionTable &getTable() { return table; };
+
+private:
+    static constexpr char MAGIC[8] = {'S', 'O', 'L', 'V', 'C', 'K', '0', '1'};
+
+    /*
+    Fixed part of a checkpoint file, followed by the solved root values
+    and the table.
+    */
+    struct CheckpointHeader
+    {
+        char magic[8];
+        uint64_t rootHash;
+        uint64_t tableBytes;
+        uint32_t moves;  //root children
+        uint32_t solved; //root children solved, in generateActions() order
+        float lower, upper, guess; //MTD(f) state of the next root child
+        uint32_t iterations;
+        uint64_t nodes, proven;
+        double seconds;
+    };
+
+    E evaluator;
+    P policy;
+    SolveOptions options;
+    TranspositionTable table;
+    MoveOrdering<A> ordering;
+
+    //State of the current solve
+    SolveProgress progress;
+    size_t rootHash = 0;
+    std::vector<float> solvedValues;
+    float lower = FLT_MAX * -1, upper = FLT_MAX; //bounds on the current root child, from its side's view
+    float guess = 0;
+    double secondsBefore = 0; //seconds of the runs resumed from
+    std::chrono::steady_clock::time_point startTime, lastProgress, lastCheckpoint;
+    unsigned int nodesToCheck = SOLVER_CHECK_INTERVAL;
+    size_t polledNodes = 0;
+    bool stopped = false;
+
+    float mtdf(G *state, int color);
+    float search(G *state, unsigned int ply, float a, float b, int color);
+    float searchChild(G *state, unsigned int ply, float a, float b, int color);
+    void reportBounds(int color);
+    bool stopping();
+    void updateSeconds();
+    void writeCheckpoint();
+    bool readCheckpoint();
+};
+
+#include "Solver.tpp"
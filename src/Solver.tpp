@@ -0,0 +1,343 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include "Solver.h"
+
+/*
+Constructor
+evaluator and policy are as for StaticSearch::SearchDepth().
+*/
+template <class G, class E, class P>
+Solver<G, E, P>::Solver(const E &evaluator, const P &policy, const SolveOptions &options)
+    : evaluator{evaluator}, policy{policy}, options{options}, table(options.megabytes)
+{
+}
+
+/*
+Solves rootState: the value of every root child with perfect play by both
+sides, and a best move.  With options.resume, continues from the checkpoint
+at options.checkpointPath if there is one.
+A solve stopped by options.control returns complete = false with the
+children solved so far (after writing a checkpoint, if asked for).
+Throws runtime_error if a checkpoint cannot be written, or if the one to
+resume from is for another position or table size.
+*/
+template <class G, class E, class P>
+SolveResult<typename G::action_type> Solver<G, E, P>::solve(G *rootState)
+{
+    std::unique_ptr<G> state(rootState->clone());
+    SolveResult<A> result;
+    progress = SolveProgress();
+    solvedValues.clear();
+    secondsBefore = 0;
+    polledNodes = 0;
+    nodesToCheck = SOLVER_CHECK_INTERVAL;
+    stopped = false;
+    startTime = lastProgress = lastCheckpoint = std::chrono::steady_clock::now();
+    if (state->isABTerminalState())
+    {
+        result.complete = true;
+        result.value = evaluator(state.get());
+        return result;
+    }
+
+    rootHash = state->hash();
+    ActionList<A> actions;
+    state->generateActions(actions);
+    progress.moves = actions.size();
+    table.newSearch();
+    ordering.newSearch();
+    bool resumed = options.resume && !options.checkpointPath.empty() && readCheckpoint();
+
+    for (unsigned int move = solvedValues.size(); move < actions.size() && !stopped; move++)
+    {
+        progress.move = move;
+        state->doAction(actions[move]);
+        int color = policy.color(state.get(), 1);
+        if (!resumed) //otherwise the checkpoint's bounds are for this child
+        {
+            //Start from the previous child's value, or the position as it stands
+            lower = FLT_MAX * -1;
+            upper = FLT_MAX;
+            guess = solvedValues.empty() ? color * evaluator(state.get()) : color * solvedValues.back();
+        }
+        resumed = false;
+        reportBounds(color);
+        float value = mtdf(state.get(), color);
+        state->undoAction();
+        if (!stopped)
+            solvedValues.push_back(color * value);
+    }
+
+    updateSeconds();
+    if (!options.checkpointPath.empty())
+        writeCheckpoint();
+    if (options.progress)
+        options.progress(progress);
+    result.complete = solvedValues.size() == actions.size();
+    result.value = FLT_MAX * -1;
+    for (size_t i = 0; i < solvedValues.size(); i++)
+    {
+        result.moves.push_back(actions[i]);
+        result.values.push_back(solvedValues[i]);
+        if (solvedValues[i] > result.value)
+        {
+            result.value = solvedValues[i];
+            result.move = actions[i];
+        }
+    }
+    result.progress = progress;
+    return result;
+}
+
+/*
+Proves the value of state (a root child) from the point of view of color,
+narrowing lower/upper with null-window searches around guess.
+Returns the value, or anything if stopped.
+*/
+template <class G, class E, class P>
+float Solver<G, E, P>::mtdf(G *state, int color)
+{
+    while (lower < upper)
+    {
+        guess = std::max(lower, std::min(upper, guess));
+        //Test "value > test": from the lower bound up, otherwise "value >= guess"
+        float test = guess == lower ? guess : std::nextafter(guess, FLT_MAX * -1);
+        float value = search(state, 1, test, std::nextafter(test, FLT_MAX), color);
+        if (stopped)
+            break;
+        progress.iterations++;
+        if (value > test)
+            lower = value;
+        else
+            upper = value;
+        guess = value;
+        reportBounds(color);
+    }
+    return lower;
+}
+
+/*
+Sets progress.lower/upper to the bounds on the current root child, for the
+root's maximizing side.
+*/
+template <class G, class E, class P>
+void Solver<G, E, P>::reportBounds(int color)
+{
+    progress.lower = color > 0 ? lower : -upper;
+    progress.upper = color > 0 ? upper : -lower;
+}
+
+/*
+Fail-soft negamax alpha-beta search of state to the end of the game, ply
+moves below the root.  Values are from the point of view of color, as in
+StaticSearch::negamax().  Every result is stored in the table, with the
+bit length of the nodes it took as its depth.
+*/
+template <class G, class E, class P>
+float Solver<G, E, P>::search(G *state, unsigned int ply, float a, float b, int color)
+{
+    //Check if we should stop; the value is discarded
+    if (stopping())
+        return 0;
+    //Known result (e.g. endgame tablebase)
+    if (state->resolveExact())
+    {
+        float value = color * evaluator(state);
+        state->undoAction();
+        return value;
+    }
+    if (state->isABTerminalState())
+        return color * evaluator(state);
+
+    size_t hash = state->hash(), nodesBefore = progress.nodes;
+    TTEntry entry;
+    unsigned int ttMove = NO_MOVE_INDEX;
+    bool hit = table.probe(hash, entry);
+    if (hit)
+    {
+        //Every entry is a proof to the end of the game, whatever its depth
+        ttMove = entry.moveIndex;
+        if (entry.bound == TT_EXACT)
+            return entry.value;
+        if (entry.bound == TT_LOWER)
+            a = std::max(a, entry.value);
+        else
+            b = std::min(b, entry.value);
+        if (a >= b)
+            return entry.value;
+    }
+    float aStart = a;
+    unsigned int side = color > 0 ? 0 : 1;
+
+    //Table move first, then as ordered for StaticSearch
+    ActionList<A> actions;
+    unsigned int indices[MAX_ACTIONS];
+    int hints[MAX_ACTIONS] = {};
+    unsigned int ids[MAX_ACTIONS] = {};
+    state->generateActions(actions);
+    for (unsigned int i = 0; i < actions.size(); i++)
+    {
+        hints[i] = state->actionHint(actions[i]);
+        ids[i] = state->actionId(actions[i]);
+    }
+    ordering.order(actions, hints, ids, ply, side, ttMove, indices);
+
+    float value = FLT_MAX * -1;
+    unsigned int bestIndex = NO_MOVE_INDEX;
+    for (unsigned int i = 0; i < actions.size(); i++)
+    {
+        const A &action = actions[indices[i]];
+        state->doAction(action);
+        float childValue = searchChild(state, ply + 1, a, b, color);
+        state->undoAction();
+        if (stopped)
+            return 0;
+        if (childValue > value)
+        {
+            value = childValue;
+            bestIndex = indices[i];
+        }
+        if (value >= b)
+        {
+            ordering.cutoff(action, state->actionId(action), ply, side,
+                            64 - __builtin_clzll(progress.nodes - nodesBefore));
+            break;
+        }
+        a = std::max(a, value);
+    }
+    TTBound bound = value <= aStart ? TT_UPPER : value >= b ? TT_LOWER : TT_EXACT;
+    //A bound meeting the opposite one already stored proves the value
+    if (hit && bound != TT_EXACT && entry.bound != bound && entry.value == value)
+        bound = TT_EXACT;
+    table.store(hash, 64 - __builtin_clzll(progress.nodes - nodesBefore), value, bound, bestIndex);
+    progress.proven++;
+    return value;
+}
+
+/*
+Searches the child reached by the action just applied to state and returns
+its value from the point of view of its parent's color.
+*/
+template <class G, class E, class P>
+float Solver<G, E, P>::searchChild(G *state, unsigned int ply, float a, float b, int color)
+{
+    int childColor = policy.color(state, color);
+    //Same side moves again: same point of view
+    if (childColor == color)
+        return search(state, ply, a, b, childColor);
+    return -search(state, ply, -b, -a, childColor);
+}
+
+/*
+Counts a node and, every SOLVER_CHECK_INTERVAL nodes, polls options.control
+and reports progress or writes a checkpoint when they are due.
+Returns true if the solve has to stop.
+*/
+template <class G, class E, class P>
+bool Solver<G, E, P>::stopping()
+{
+    progress.nodes++;
+    if (--nodesToCheck > 0)
+        return stopped;
+    nodesToCheck = SOLVER_CHECK_INTERVAL;
+    if (options.control)
+        stopped = options.control->poll(progress.nodes - polledNodes);
+    polledNodes = progress.nodes;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (options.progress && now - lastProgress >= options.progressInterval)
+    {
+        lastProgress = now;
+        updateSeconds();
+        options.progress(progress);
+    }
+    //The table only holds finished proofs, so it can be saved mid-search
+    if (!options.checkpointPath.empty() && now - lastCheckpoint >= options.checkpointInterval)
+    {
+        updateSeconds();
+        writeCheckpoint();
+        lastCheckpoint = std::chrono::steady_clock::now();
+    }
+    return stopped;
+}
+
+template <class G, class E, class P>
+void Solver<G, E, P>::updateSeconds()
+{
+    progress.seconds =
+        secondsBefore + std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/*
+Writes the solve's progress and table to options.checkpointPath.  The file
+is written beside it first and then renamed over it, so a crash while
+writing leaves the previous checkpoint intact.
+Throws runtime_error if it cannot be written.
+*/
+template <class G, class E, class P>
+void Solver<G, E, P>::writeCheckpoint()
+{
+    std::string temporary = options.checkpointPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("cannot write checkpoint " + temporary);
+        CheckpointHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.rootHash = rootHash;
+        header.tableBytes = table.getMemory();
+        header.moves = progress.moves;
+        header.solved = solvedValues.size();
+        header.lower = lower;
+        header.upper = upper;
+        header.guess = guess;
+        header.iterations = progress.iterations;
+        header.nodes = progress.nodes;
+        header.proven = progress.proven;
+        header.seconds = progress.seconds;
+        out.write((const char *)&header, sizeof(header));
+        out.write((const char *)solvedValues.data(), solvedValues.size() * sizeof(float));
+        table.write(out);
+        out.close();
+        if (!out)
+            throw std::runtime_error("cannot write checkpoint " + temporary);
+    }
+    std::filesystem::rename(temporary, options.checkpointPath);
+}
+
+/*
+Restores the progress and table saved by writeCheckpoint().
+Returns false if there is no checkpoint file.
+Throws runtime_error if it cannot be read or is for another position or
+table size.
+*/
+template <class G, class E, class P>
+bool Solver<G, E, P>::readCheckpoint()
+{
+    std::ifstream in(options.checkpointPath, std::ios::binary);
+    if (!in)
+        return false;
+    CheckpointHeader header;
+    if (!in.read((char *)&header, sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error(options.checkpointPath + " is not a solver checkpoint");
+    if (header.rootHash != rootHash || header.moves != progress.moves || header.solved > header.moves)
+        throw std::runtime_error(options.checkpointPath + " is a checkpoint of another position");
+    if (header.tableBytes != table.getMemory())
+        throw std::runtime_error(options.checkpointPath + " was saved with a " +
+                                 std::to_string(header.tableBytes >> 20) + "MB table");
+    solvedValues.resize(header.solved);
+    if (!in.read((char *)solvedValues.data(), solvedValues.size() * sizeof(float)))
+        throw std::runtime_error("cannot read checkpoint " + options.checkpointPath);
+    table.read(in);
+    progress.move = header.solved;
+    lower = header.lower;
+    upper = header.upper;
+    progress.iterations = header.iterations;
+    progress.nodes = polledNodes = header.nodes;
+    progress.proven = header.proven;
+    progress.seconds = secondsBefore = header.seconds;
+    guess = header.guess;
+    return true;
+}
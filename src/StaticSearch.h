@@ -0,0 +1,172 @@
+#pragma once
+/*
+Alpha-beta search with the game, evaluator and layer policy as template
+parameters, so every call in the search is resolved at compile time and can
+be inlined.  ABSearch adapts ABSearchableState's virtual interface and
+function pointers to it.
+
+G - game state.  Needs typedef action_type and
+    void generateActions(ActionList<action_type> &), size_t hash(),
+    void doAction(action_type), void undoAction(), bool isABTerminalState(),
+    int actionHint(action_type), unsigned int actionId(action_type), bool resolveExact(),
+    size_t canonicalHash(bool &)
+    and G *clone().
+E - evaluator.  float operator()(G *state) const, utility for the maximizing side.
+P - layer policy.  int color(G *state, int parentColor) const, 1 if state is
+    a maximizing layer, -1 if minimizing.
+Declare game classes final so calls through G * are not virtual.
+*/
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include "ActionList.h"
+#include "MoveOrdering.h"
+#include "SearchControl.h"
+#include "TranspositionTable.h"
+
+//Defaults
+const float DEFAULT_PRECISION = 0.001; //for checking float equality
+const float DEFAULT_ASPIRATION_WINDOW = 1; //first aspiration window half-width, in utility units
+const unsigned int ASPIRATION_RETRIES = 3; //widenings before searching with a full window
+#ifndef DEBUG_LEVEL
+const int DEBUG_LEVEL = 0; //1 for some console printing
+#endif
+
+/*
+Counters collected by a search when asked for (they cost a few increments
+per node).  Counters of several searches, e.g. one per thread, add up.
+*/
+struct SearchStats
+{
+    size_t leaves = 0;           //positions evaluated by the utility function
+    size_t cutoffs = 0;          //nodes whose search failed high (beta cutoffs)
+    size_t firstMoveCutoffs = 0; //of those, cut off by the first child searched
+    size_t ttProbes = 0;         //transposition table lookups
+    size_t ttHits = 0;           //lookups that found the position
+
+    SearchStats &operator+=(const SearchStats &other)
+    {
+        leaves += other.leaves;
+        cutoffs += other.cutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        ttProbes += other.ttProbes;
+        ttHits += other.ttHits;
+        return *this;
+    };
+    //fraction of cutoffs made by the first child, a measure of move ordering
+    double firstMoveCutoffRate() const { return cutoffs ? (double)firstMoveCutoffs / cutoffs : 0; };
+    double ttHitRate() const { return ttProbes ? (double)ttHits / ttProbes : 0; };
+};
+
+/*
+One iteration of an iterative deepening search.
+*/
+struct IterationStats
+{
+    unsigned int depth;
+    float value;
+    bool complete;  //false if stopped after only some root moves
+    size_t nodes;
+    double seconds; //wall time of the iteration
+};
+
+/*
+Outcome of a search.
+*/
+template <class A>
+struct SearchResult
+{
+    A move{};               //best move found
+    float value = 0;        //utility of move
+    unsigned int depth = 0; //depth of the search that produced move (0 if none)
+    bool complete = true;   //false if that search was stopped after only some root moves
+    size_t nodes = 0;       //nodes searched
+    std::vector<A> pv;      //principal variation, starting with move
+    double seconds = 0;     //wall time
+    SearchStats stats;      //only counted if asked for
+    std::vector<IterationStats> iterations; //iterative deepening only
+
+    /*
+    Effective branching factor: the b for which a uniform tree of the
+    searched depth would have as many nodes.
+    */
+    double branchingFactor() const { return depth ? std::pow((double)nodes, 1.0 / depth) : 0; };
+};
+
+/*
+Search window techniques.  All off gives plain alpha-beta.
+*/
+struct WindowOptions
+{
+    bool pvs = true;        //principal variation search: null windows after the first child
+    bool aspiration = true; //root window around the previous iteration's value
+    float aspirationWindow = DEFAULT_ASPIRATION_WINDOW;
+};
+
+/*
+Layer policy for games where players strictly alternate.
+*/
+struct AlternatingLayers
+{
+    template <class G>
+    int color(G *state, int parentColor) const { return -parentColor; };
+};
+
+template <class G, class E, class P = AlternatingLayers>
+class StaticSearch
+{
+public:
+    typedef typename G::action_type A;
+
+    static SearchResult<A> SearchDepth(G *rootState, const E &evaluator, unsigned int maxDepth,
+                                       float comparePrecision = DEFAULT_PRECISION,
+                                       const P &policy = P(), TranspositionTable *table = nullptr,
+                                       const SearchResult<A> *previous = nullptr,
+                                       SearchControl *control = nullptr,
+                                       MoveOrdering<A> *ordering = nullptr,
+                                       const WindowOptions &windows = WindowOptions(),
+                                       bool collectStats = false,
+                                       bool symmetry = false);
+
+private:
+    /*
+    Settings shared by every layer of one search.
+    */
+    struct Context
+    {
+        const E &evaluator;
+        const P &policy;
+        TranspositionTable *table;
+        unsigned int maxDepth;
+        const std::vector<A> &pv;       //searched first while the search follows it
+        const WindowOptions &windows;
+        SearchControl &control;
+        MoveOrdering<A> &ordering;
+        bool collectStats;              //count stats
+        bool symmetry;                  //table keys from canonicalHash()
+        unsigned int nodesToCheck = 1;  //countdown to the next control.stopped() poll
+        bool stopped = false;           //search was stopped, results are incomplete
+        size_t nodes = 0;
+        SearchStats stats = {};
+        ActionList<A> rootMoves = {};   //root moves with final values, in search order
+        float rootValues[MAX_ACTIONS] = {}; //their values
+        size_t polledNodes = 0;         //nodes at the last control.poll()
+    };
+
+    static float negamax(G *state, unsigned int ply, float a, float b, int color,
+                         Context &context, bool onPV);
+    static float searchChild(G *state, unsigned int ply, float a, float b, int color,
+                             Context &context, bool onPV);
+    static bool orderActions(G *state, unsigned int ply, Context &context, bool onPV,
+                             unsigned int side, unsigned int ttMove,
+                             ActionList<A> &actions, unsigned int *indices);
+    static void principalVariation(G *state, TranspositionTable *table, bool symmetry, unsigned int depth,
+                                   std::vector<A> &pv);
+    static size_t tableKey(G *state, bool symmetry, bool &mirrored);
+    static TTBound boundType(float value, float a, float b);
+    static TTBound flipBound(TTBound bound);
+    static bool stopping(Context &context);
+};
+
+#include "StaticSearch.tpp"
@@ -0,0 +1,377 @@
+#pragma once
+#include "StaticSearch.h"
+
+/*
+Performs one fixed depth search and returns the best move, its value and the
+principal variation.  Used by iterative deepening: previous is the last
+iteration's result, whose principal variation is searched first and whose
+value centres the aspiration window.
+evaluator(state) gives the utility of a state for the maximizing side and
+policy decides which layers maximize.
+The search stops when control is stopped (never if nullptr).  A stopped
+search still returns the best of the
+root moves it finished, with result.complete = false, or result.depth = 0
+if it finished none.
+ordering carries killer moves and history between iterations (a fresh one
+with every heuristic on is used if nullptr).
+collectStats fills in result.stats.
+symmetry shares table entries between a state and its mirror image (see
+ABSearchableState::canonicalHash()).  Values are then stored as the
+evaluator's, negated for mirror images, so this needs an evaluator that
+negates under the mirror and a policy that follows the player to move.
+*/
+template <class G, class E, class P>
+SearchResult<typename G::action_type> StaticSearch<G, E, P>::SearchDepth(G *rootState, const E &evaluator,
+                                                                        unsigned int maxDepth, float comparePrecision,
+                                                                        const P &policy, TranspositionTable *table,
+                                                                        const SearchResult<A> *previous,
+                                                                        SearchControl *control,
+                                                                        MoveOrdering<A> *ordering,
+                                                                        const WindowOptions &windows,
+                                                                        bool collectStats, bool symmetry)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    TranspositionTable *localTable = nullptr;
+    if (table == nullptr)
+        table = localTable = new TranspositionTable(1);
+    SearchControl *localControl = nullptr;
+    if (control == nullptr)
+        control = localControl = new SearchControl();
+    MoveOrdering<A> localOrdering;
+    if (ordering == nullptr)
+        ordering = &localOrdering;
+    ordering->newSearch();
+    bool followPrevious = previous != nullptr && previous->depth > 0;
+    std::vector<A> noPV;
+    //Single mutable state walked by the whole search
+    G *state = rootState->clone();
+    Context context = {evaluator, policy, table, maxDepth, followPrevious ? previous->pv : noPV,
+                       windows, *control, *ordering, collectStats, symmetry};
+    try
+    {
+        //Aspiration window: expect about the previous value, widen on failure
+        float a = FLT_MAX * -1, b = FLT_MAX, delta = windows.aspirationWindow;
+        if (windows.aspiration && followPrevious && previous->complete)
+        {
+            a = std::max(previous->value - delta, FLT_MAX * -1);
+            b = std::min(previous->value + delta, FLT_MAX);
+        }
+        SearchResult<A> result;
+        for (unsigned int attempt = 1;; attempt++)
+        {
+            //Begin recursive search (the root is always a maximizing layer)
+            result.value = negamax(state, 0, a, b, 1, context, true);
+            if (context.stopped || ((result.value > a || a == FLT_MAX * -1) &&
+                                    (result.value < b || b == FLT_MAX)))
+                break;
+            delta *= 4;
+            if (result.value <= a)
+                a = attempt < ASPIRATION_RETRIES ? std::max(result.value - delta, FLT_MAX * -1) : FLT_MAX * -1;
+            else
+                b = attempt < ASPIRATION_RETRIES ? std::min(result.value + delta, FLT_MAX) : FLT_MAX;
+        }
+        result.nodes = context.nodes;
+        result.stats = context.stats;
+
+        size_t searched = context.rootMoves.size();
+        if (context.stopped)
+        {
+            //Keep the best of the root moves that finished
+            result.complete = false;
+            result.value = FLT_MAX * -1;
+            for (size_t i = 0; i < searched; i++)
+                result.value = std::max(result.value, context.rootValues[i]);
+        }
+        if (!context.stopped || searched > 0)
+        {
+            result.depth = maxDepth;
+            //Find best move
+            for (size_t i = 0; i < searched; i++)
+                if (context.rootValues[i] + comparePrecision >= result.value)
+                {
+                    result.move = context.rootMoves[i];
+                    break;
+                }
+            //Follow the table's best moves for the rest of the line
+            if (searched > 0)
+            {
+                result.pv.push_back(result.move);
+                state->doAction(result.move);
+                principalVariation(state, table, symmetry, maxDepth - 1, result.pv);
+            }
+        }
+        delete state;        //clean up
+        delete localTable;   //clean up
+        delete localControl; //clean up
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        // Print some search information to console
+        if (DEBUG_LEVEL)
+            printf("Depth: %d | Utility: %f%s\n", maxDepth, result.value, result.complete ? "" : " (partial)");
+        return result;
+    }
+    // If exception, do some cleanup and let calling function deal with it
+    catch (...)
+    {
+        delete state;
+        delete localTable;
+        delete localControl;
+        throw;
+    }
+}
+
+/*
+Appends the best moves stored in table, starting from state, to pv.
+*/
+template <class G, class E, class P>
+void StaticSearch<G, E, P>::principalVariation(G *state, TranspositionTable *table, bool symmetry,
+                                               unsigned int depth, std::vector<A> &pv)
+{
+    TTEntry entry;
+    bool mirrored;
+    if (depth == 0 || state->isABTerminalState() ||
+        !table->probe(tableKey(state, symmetry, mirrored), entry) || entry.moveIndex == NO_MOVE_INDEX)
+        return;
+    ActionList<A> actions;
+    state->generateActions(actions);
+    if (entry.moveIndex >= actions.size())
+        return;
+    pv.push_back(actions[entry.moveIndex]);
+    state->doAction(actions[entry.moveIndex]);
+    principalVariation(state, table, symmetry, depth - 1, pv);
+    state->undoAction();
+}
+
+/*
+Table key of state: its hash, or with symmetry, the hash of its canonical
+form (setting mirrored if that is its mirror image).
+*/
+template <class G, class E, class P>
+size_t StaticSearch<G, E, P>::tableKey(G *state, bool symmetry, bool &mirrored)
+{
+    mirrored = false;
+    return symmetry ? state->canonicalHash(mirrored) : state->hash();
+}
+
+/*
+Counts a node and checks if the search has to stop, polling the control
+every few nodes.
+*/
+template <class G, class E, class P>
+bool StaticSearch<G, E, P>::stopping(Context &context)
+{
+    context.nodes++;
+    if (--context.nodesToCheck == 0)
+    {
+        context.nodesToCheck = context.control.getCheckInterval();
+        context.stopped = context.control.poll(context.nodes - context.polledNodes);
+        context.polledNodes = context.nodes;
+    }
+    return context.stopped;
+}
+
+/*
+Classifies a node's search result for the transposition table,
+given the window (a, b) the node was searched with.
+*/
+template <class G, class E, class P>
+TTBound StaticSearch<G, E, P>::boundType(float value, float a, float b)
+{
+    if (value <= a)
+        return TT_UPPER;
+    if (value >= b)
+        return TT_LOWER;
+    return TT_EXACT;
+}
+
+/*
+Bound of the negated value.
+*/
+template <class G, class E, class P>
+TTBound StaticSearch<G, E, P>::flipBound(TTBound bound)
+{
+    return bound == TT_LOWER ? TT_UPPER : bound == TT_UPPER ? TT_LOWER : bound;
+}
+
+/*
+Generates the actions at state, ordered by context.ordering so the move most
+likely to be best is searched first: the principal variation move while on
+it, otherwise the table's best move from an earlier search.
+side is 0 in maximizing layers and 1 in minimizing ones.
+indices receives the search order as positions in actions (generateActions() order).
+Returns true if the first action continues the principal variation.
+*/
+template <class G, class E, class P>
+bool StaticSearch<G, E, P>::orderActions(G *state, unsigned int ply, Context &context,
+                                         bool onPV, unsigned int side, unsigned int ttMove,
+                                         ActionList<A> &actions, unsigned int *indices)
+{
+    state->generateActions(actions);
+    unsigned int first = ttMove;
+    bool pvFirst = false;
+    if (onPV && ply < context.pv.size())
+        for (unsigned int i = 0; i < actions.size(); i++)
+            if (actions[i] == context.pv[ply])
+            {
+                first = i;
+                pvFirst = true;
+                break;
+            }
+    int hints[MAX_ACTIONS] = {};
+    bool useHints = context.ordering.getOptions().hints;
+    if (useHints)
+        for (unsigned int i = 0; i < actions.size(); i++)
+            hints[i] = state->actionHint(actions[i]);
+    unsigned int ids[MAX_ACTIONS];
+    bool useHistory = context.ordering.getOptions().history;
+    if (useHistory)
+        for (unsigned int i = 0; i < actions.size(); i++)
+            ids[i] = state->actionId(actions[i]);
+    context.ordering.order(actions, useHints ? hints : nullptr, useHistory ? ids : nullptr, ply, side, first,
+                           indices);
+    return pvFirst && indices[0] == first;
+}
+
+/*
+Negamax alpha-beta search of state, ply moves below the root.
+Values are from the point of view of color: 1 in maximizing layers, -1 in
+minimizing ones (as the policy decides), so a move that keeps the turn
+is searched without flipping the sign or the window.
+After the first child, children are only tested with a null window just
+above a (principal variation search) and fully searched if they beat it.
+Runs entirely on the call stack: each move is applied to state on the way
+down and undone on the way back up, and only the root keeps its children's
+values (context.rootMoves/rootValues).
+*/
+template <class G, class E, class P>
+float StaticSearch<G, E, P>::negamax(G *state, unsigned int ply, float a, float b,
+                                     int color, Context &context, bool onPV)
+{
+    //Check if we should stop; the value is discarded
+    if (stopping(context))
+        return 0;
+    //Known result (e.g. endgame tablebase): value of the final position it leads to
+    if (ply > 0 && state->resolveExact())
+    {
+        if (context.collectStats)
+            context.stats.leaves++;
+        float value = color * context.evaluator(state);
+        state->undoAction();
+        return value;
+    }
+    //Check for terminal tree node
+    if (ply >= context.maxDepth || state->isABTerminalState())
+    {
+        if (context.collectStats)
+            context.stats.leaves++;
+        return color * context.evaluator(state);
+    }
+
+    unsigned int remainingDepth = context.maxDepth - ply;
+    bool mirrored;
+    size_t hash = tableKey(state, context.symmetry, mirrored);
+    //With symmetry, entries hold the evaluator's values for the canonical form
+    int sign = context.symmetry ? (mirrored ? -color : color) : 1;
+    TTEntry entry;
+    unsigned int ttMove = NO_MOVE_INDEX;
+    bool hit = context.table->probe(hash, entry);
+    if (context.collectStats)
+    {
+        context.stats.ttProbes++;
+        context.stats.ttHits += hit;
+    }
+    if (hit && sign < 0)
+    {
+        entry.value = -entry.value;
+        entry.bound = flipBound(entry.bound);
+    }
+    if (hit)
+    {
+        ttMove = entry.moveIndex;
+        //Use a stored result searched at least as deep
+        //(except at the root, which needs every child's value)
+        if (ply > 0 && entry.depth >= remainingDepth)
+        {
+            if (entry.bound == TT_EXACT)
+                return entry.value;
+            if (entry.bound == TT_LOWER)
+                a = std::max(a, entry.value);
+            else
+                b = std::min(b, entry.value);
+            if (a >= b)
+                return entry.value;
+        }
+    }
+    float aStart = a;
+    unsigned int side = color > 0 ? 0 : 1;
+
+    float value = FLT_MAX * -1;
+    unsigned int bestIndex = NO_MOVE_INDEX;
+    //Get valid actions in search order
+    ActionList<A> actions;
+    unsigned int indices[MAX_ACTIONS];
+    bool pvFirst = orderActions(state, ply, context, onPV, side, ttMove, actions, indices);
+    if (ply == 0)
+        context.rootMoves.clear();
+
+    //Process each child
+    for (unsigned int i = 0; i < actions.size(); i++)
+    {
+        const A &action = actions[indices[i]];
+        float childValue;
+        state->doAction(action); //Apply the action
+        if (i == 0 || !context.windows.pvs)
+            childValue = searchChild(state, ply + 1, a, b, color, context, pvFirst && i == 0);
+        else
+        {
+            //Null window: only find out whether the child beats a
+            childValue = searchChild(state, ply + 1, a, std::nextafter(a, FLT_MAX), color, context, false);
+            if (childValue > a && childValue < b && !context.stopped)
+                childValue = searchChild(state, ply + 1, a, b, color, context, false);
+        }
+        state->undoAction(); //Back to this node's state
+        //Stopped: child's value is incomplete, leave without storing anything
+        if (context.stopped)
+            return 0;
+        if (ply == 0)
+        {
+            context.rootValues[context.rootMoves.size()] = childValue;
+            context.rootMoves.push_back(action);
+        }
+        //Perform A-B pruning actions
+        if (childValue > value)
+        {
+            value = childValue;
+            bestIndex = indices[i];
+        }
+        if (value >= b)
+        {
+            if (context.collectStats)
+            {
+                context.stats.cutoffs++;
+                context.stats.firstMoveCutoffs += i == 0;
+            }
+            context.ordering.cutoff(action, state->actionId(action), ply, side, remainingDepth);
+            break;
+        }
+        a = std::max(a, value);
+    }
+    TTBound bound = boundType(value, aStart, b);
+    context.table->store(hash, remainingDepth, sign * value, sign < 0 ? flipBound(bound) : bound, bestIndex);
+    return value;
+}
+
+/*
+Searches the child reached by the action just applied to state and returns
+its value from the point of view of its parent's color.
+*/
+template <class G, class E, class P>
+float StaticSearch<G, E, P>::searchChild(G *state, unsigned int ply, float a, float b,
+                                         int color, Context &context, bool onPV)
+{
+    int childColor = context.policy.color(state, color);
+    //Same side moves again: same point of view
+    if (childColor == color)
+        return negamax(state, ply, a, b, childColor, context, onPV);
+    return -negamax(state, ply, -b, -a, childColor, context, onPV);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include "ThreadPool.h"
+
+/*
+Constructor
+Starts threads workers, each with its own task queue.
+*/
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    if (threads == 0)
+        threads = 1;
+    for (size_t i = 0; i < threads; i++)
+        queues.emplace_back(new Queue());
+    for (size_t i = 0; i < threads; i++)
+        workers.emplace_back(&ThreadPool::run, this, i);
+}
+
+/*
+Destructor
+Finishes queued tasks, then joins the workers.
+*/
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+/*
+Returns the process-wide pool, started on first use.
+*/
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+/*
+Queues task.  Tasks submitted from a worker go on that worker's own queue,
+others are spread over the queues in turn.
+*/
+void ThreadPool::submit(std::function<void()> task)
+{
+    size_t index = workerIndex();
+    if (index >= queues.size())
+        index = nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+/*
+Takes the newest task from queue index, or steals the oldest one from another queue.
+*/
+bool ThreadPool::takeTask(size_t index, std::function<void()> &task)
+{
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        Queue &other = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(other.lock);
+        if (!other.tasks.empty())
+        {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+Worker loop.  Sleeps until there is a task to take or the pool is stopping.
+*/
+void ThreadPool::run(size_t index)
+{
+    workerIndex() = index;
+    std::function<void()> task;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this]
+                      { return pending > 0 || stopping; });
+            if (pending == 0)
+                return; //stopping with nothing left to do
+            pending--;
+        }
+        //A task is reserved for us; it may sit on another queue for a moment
+        while (!takeTask(index, task))
+            std::this_thread::yield();
+        task();
+        task = nullptr;
+    }
+}
+
+size_t &ThreadPool::workerIndex()
+{
+    static thread_local size_t index = SIZE_MAX;
+    return index;
+}
+
+/*
+Submits task to pool as part of this group.
+*/
+void TaskGroup::run(ThreadPool &pool, std::function<void()> task)
+{
+    std::shared_ptr<Task> queued = std::make_shared<Task>();
+    queued->work = std::move(task);
+    tasks.push_back(queued);
+    {
+        std::lock_guard<std::mutex> guard(state->lock);
+        state->active++;
+    }
+    std::shared_ptr<State> shared = state;
+    pool.submit([queued, shared]
+                {
+                    //wait() may have run it already
+                    if (queued->started.exchange(true))
+                        return;
+                    queued->work();
+                    finish(*shared); });
+}
+
+/*
+Runs the group's tasks that haven't started yet, then blocks until every task
+in the group has finished.
+*/
+void TaskGroup::wait()
+{
+    for (auto &task : tasks)
+        if (!task->started.exchange(true))
+        {
+            task->work();
+            task->work = nullptr;
+            finish(*state);
+        }
+    tasks.clear();
+    std::unique_lock<std::mutex> guard(state->lock);
+    state->done.wait(guard, [this]
+                     { return state->active == 0; });
+}
+
+/*
+Counts one of the group's tasks as finished.
+*/
+void TaskGroup::finish(State &state)
+{
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (--state.active == 0)
+        state.done.notify_all();
+}
@@ -0,0 +1,84 @@
+#pragma once
+/*
+Long-lived pool of worker threads with work stealing.
+Each worker has its own task deque: it takes its newest task first and, when
+empty, steals the oldest task from another worker.  Idle workers sleep on a
+condition variable, so submitting work never polls.
+*/
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    //construct/destruct
+    ThreadPool(size_t threads = 0); //0 = hardware_concurrency() - 1 (the caller is the last thread)
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+    size_t getThreadCount() { return workers.size(); };
+
+    //Pool shared by everything that doesn't bring its own
+    static ThreadPool &shared();
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    size_t pending = 0; //submitted but not yet started
+    bool stopping = false;
+    std::atomic<size_t> nextQueue{0};
+
+    void run(size_t index);
+    bool takeTask(size_t index, std::function<void()> &task);
+    static size_t &workerIndex(); //index of the calling worker (SIZE_MAX outside the pool)
+};
+
+/*
+Tracks a set of tasks submitted to a pool so they can be waited on.
+wait() runs the group's tasks that no worker has started yet on the calling
+thread, so a busy pool can delay a group's tasks but never its wait().
+run() and wait() are called from one thread.
+*/
+class TaskGroup
+{
+public:
+    ~TaskGroup() { wait(); };
+
+    void run(ThreadPool &pool, std::function<void()> task);
+    void wait();
+
+private:
+    struct Task
+    {
+        std::function<void()> work;
+        std::atomic<bool> started{false};
+    };
+    //Shared with the tasks still queued, which may outlive the group
+    struct State
+    {
+        std::mutex lock;
+        std::condition_variable done;
+        size_t active = 0;
+    };
+
+    std::shared_ptr<State> state = std::make_shared<State>();
+    std::vector<std::shared_ptr<Task>> tasks; //submitted since the last wait()
+
+    static void finish(State &state);
+};
+
+#include "ThreadPool.cpp"
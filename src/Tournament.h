@@ -0,0 +1,139 @@
+#pragma once
+/*
+Bot versus bot matches for comparing utility functions and search settings.
+Games run concurrently, one search thread each, on a thread pool.  Each
+opening (a few random moves from the start position) is played twice with
+the players' sides swapped, so neither gains from a lucky opening or from
+moving first.  Moves come from Game::getAIMove() (or Game::getMCTSMove()),
+with a separate game copy and transposition table for each player.
+The result gives the score of player a against player b, the Elo
+difference it implies and a sequential probability ratio test (SPRT) of
+whether a is stronger.
+*/
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <string>
+#include "Game.h"
+
+//Defaults
+const unsigned int DEFAULT_TOURNAMENT_GAMES = 200;
+const unsigned int DEFAULT_OPENING_PLIES = 4;   //random moves before the bots take over
+const unsigned int MAX_OPENING_TRIES = 1000;    //random lines tried for one opening before giving up
+const size_t DEFAULT_TOURNAMENT_TABLE_MB = 4;   //per player per game
+const unsigned int MAX_GAME_PLIES = 1000;       //longer games are drawn
+
+/*
+One side of a match.  utility and maxLayer are used when playing as player 1
+(index 0) and as player 2 (index 1), since they are written from one player's
+point of view.
+*/
+template <class S, class A>
+struct TournamentPlayer
+{
+    std::string name;
+    float (*utility[2])(ABSearchableState<S, A> *) = {nullptr, nullptr};
+    bool (*maxLayer[2])(ABSearchableState<S, A> *) = {nullptr, nullptr};
+    std::chrono::milliseconds time = DEFAULT_TIME; //per move
+    SearchOptions options;                         //maxDepth and maxNodes limit each move; threads is ignored
+    bool mcts = false;                             //search with MCTS instead of alpha-beta
+    MCTSOptions mctsOptions;                       //maxRollouts limits each move; threads is ignored
+};
+
+/*
+Match settings.
+*/
+struct TournamentOptions
+{
+    unsigned int games = DEFAULT_TOURNAMENT_GAMES; //rounded up to an even number
+    unsigned int threads = 0;                      //games played at once (0 = hardware_concurrency())
+    unsigned int openingPlies = DEFAULT_OPENING_PLIES;
+    uint64_t seed = 1;                             //for the openings
+    size_t tableMB = DEFAULT_TOURNAMENT_TABLE_MB;
+    ThreadPool *pool = nullptr;                    //nullptr = ThreadPool::shared()
+    //SPRT of H0: elo = elo0 against H1: elo = elo1, with error rates alpha and beta
+    double elo0 = 0, elo1 = 10, alpha = 0.05, beta = 0.05;
+    bool sprtStop = false; //stop once the test decides
+};
+
+/*
+Match outcome from player a's point of view.
+*/
+struct TournamentResult
+{
+    unsigned int wins = 0, draws = 0, losses = 0;
+    size_t moves = 0;
+    size_t fallbackMoves = 0; //moves the search produced nothing for (first legal move played)
+    double seconds = 0;
+
+    unsigned int games() const { return wins + draws + losses; };
+    double score() const { return games() ? (wins + draws / 2.0) / games() : 0.5; };
+    double gamesPerSecond() const { return seconds > 0 ? games() / seconds : 0; };
+    double elo() const { return eloFromScore(score()); };
+    /*
+    Half-width of the 95% confidence interval of elo().
+    */
+    double eloMargin() const
+    {
+        if (games() < 2)
+            return INFINITY;
+        double error = 1.96 * std::sqrt(variance() / games());
+        return (eloFromScore(score() + error) - eloFromScore(score() - error)) / 2;
+    };
+    /*
+    Log likelihood ratio of elo1 over elo0 (normal approximation of the
+    game score distribution).
+    */
+    double llr(double elo0, double elo1) const
+    {
+        double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1), v = variance();
+        if (games() == 0 || v == 0)
+            return 0;
+        return (s1 - s0) * (2 * score() - s0 - s1) / (2 * v / games());
+    };
+    /*
+    SPRT decision: 1 accepts H1 (elo1), -1 accepts H0 (elo0), 0 needs more games.
+    */
+    int sprt(double elo0, double elo1, double alpha, double beta) const
+    {
+        double ratio = llr(elo0, elo1);
+        if (ratio >= std::log((1 - beta) / alpha))
+            return 1;
+        if (ratio <= std::log(beta / (1 - alpha)))
+            return -1;
+        return 0;
+    };
+
+    static double scoreFromElo(double elo) { return 1 / (1 + std::pow(10, -elo / 400)); };
+    static double eloFromScore(double score)
+    {
+        score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+        return -400 * std::log10(1 / score - 1);
+    };
+
+private:
+    //variance of a single game's score
+    double variance() const
+    {
+        double s = score();
+        return games() ? (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games() : 0;
+    };
+};
+
+template <class S, class A>
+class Tournament
+{
+public:
+    static TournamentResult run(Game<S, A> *start, const TournamentPlayer<S, A> &a,
+                                const TournamentPlayer<S, A> &b,
+                                const TournamentOptions &options = TournamentOptions());
+
+private:
+    static std::vector<Game<S, A> *> openings(Game<S, A> *start, const TournamentOptions &options);
+    static int play(Game<S, A> *opening, const TournamentPlayer<S, A> *players[2], const TournamentOptions &options,
+                    size_t &moves, size_t &fallbackMoves);
+};
+
+#include "Tournament.tpp"
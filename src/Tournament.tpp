@@ -0,0 +1,167 @@
+#pragma once
+#include "Tournament.h"
+
+/*
+Plays a match of options.games games between a and b from openings of
+start and returns the result from a's point of view.
+options.threads games are played at once: the calling thread plays games
+too, helpers run as tasks on options.pool.  Each game's moves are searched
+on one thread, within the moving player's time, depth and node limits.
+If options.sprtStop is set, no new games start once the SPRT decides.
+Throws invalid_argument if no opening of options.openingPlies can be found.
+*/
+template <class S, class A>
+TournamentResult Tournament<S, A>::run(Game<S, A> *start, const TournamentPlayer<S, A> &a,
+                                       const TournamentPlayer<S, A> &b, const TournamentOptions &options)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::vector<Game<S, A> *> starts = openings(start, options);
+    size_t games = starts.size() * 2;
+    std::atomic<size_t> nextGame{0};
+    std::atomic<bool> stopped{false};
+    std::mutex resultLock;
+    TournamentResult result;
+    std::exception_ptr error;
+    auto playGames = [&]()
+    {
+        size_t moves = 0, fallbackMoves = 0;
+        for (size_t game = nextGame++; game < games && !stopped; game = nextGame++)
+        {
+            //Each opening is played twice: a is player 1 in the first game, player 2 in the second
+            const TournamentPlayer<S, A> *players[2] = {&a, &b};
+            if (game % 2 == 1)
+                std::swap(players[0], players[1]);
+            int winner;
+            try
+            {
+                winner = play(starts[game / 2], players, options, moves, fallbackMoves);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(resultLock);
+                error = std::current_exception();
+                stopped = true;
+                break;
+            }
+            std::lock_guard<std::mutex> guard(resultLock);
+            if (winner == 0)
+                result.draws++;
+            else if (winner == (game % 2 == 0 ? 1 : 2))
+                result.wins++;
+            else
+                result.losses++;
+            if (options.sprtStop && result.sprt(options.elo0, options.elo1, options.alpha, options.beta) != 0)
+                stopped = true;
+        }
+        std::lock_guard<std::mutex> guard(resultLock);
+        result.moves += moves;
+        result.fallbackMoves += fallbackMoves;
+    };
+
+    ThreadPool &pool = options.pool ? *options.pool : ThreadPool::shared();
+    unsigned int threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    TaskGroup helpers;
+    for (unsigned int i = 1; i < threads; i++)
+        helpers.run(pool, playGames);
+    playGames();
+    helpers.wait();
+
+    for (auto opening : starts)
+        delete opening;
+    if (error)
+        std::rethrow_exception(error);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+/*
+Positions reached by options.openingPlies random moves from start, one for
+every two games (fixed by options.seed).  Openings that end the game are
+replaced.  Calling function is responsible for freeing.
+Throws invalid_argument if MAX_OPENING_TRIES lines in a row end the game
+(options.openingPlies is too long for this game).
+*/
+template <class S, class A>
+std::vector<Game<S, A> *> Tournament<S, A>::openings(Game<S, A> *start, const TournamentOptions &options)
+{
+    std::mt19937_64 random(options.seed);
+    std::vector<Game<S, A> *> positions;
+    unsigned int tries = 0; //since the last opening found
+    while (positions.size() < (options.games + 1) / 2)
+    {
+        if (tries++ == MAX_OPENING_TRIES)
+        {
+            for (auto position : positions)
+                delete position;
+            throw std::invalid_argument("every opening of " + std::to_string(options.openingPlies) +
+                                        " plies tried ends the game");
+        }
+        Game<S, A> *position = start->clone();
+        for (unsigned int ply = 0; ply < options.openingPlies && position->getWinner() < 0; ply++)
+        {
+            ActionList<A> moves;
+            position->getValidMoves(moves);
+            position->makeMove(moves[random() % moves.size()]);
+        }
+        if (position->getWinner() < 0)
+        {
+            positions.push_back(position);
+            tries = 0;
+        }
+        else
+            delete position;
+    }
+    return positions;
+}
+
+/*
+Plays one game from opening with players[0] as player 1 and players[1] as
+player 2.  Returns the winner (0 for a draw).
+Each player searches its own copy of the game, so each keeps its own
+transposition table between its moves.  If a search finishes nothing in
+time, the first legal move is played and counted in fallbackMoves.
+*/
+template <class S, class A>
+int Tournament<S, A>::play(Game<S, A> *opening, const TournamentPlayer<S, A> *players[2],
+                           const TournamentOptions &options, size_t &moves, size_t &fallbackMoves)
+{
+    std::unique_ptr<Game<S, A>> views[2] = {std::unique_ptr<Game<S, A>>(opening->clone()),
+                                            std::unique_ptr<Game<S, A>>(opening->clone())};
+    for (int side = 0; side < 2; side++)
+    {
+        SearchOptions search = players[side]->options;
+        search.threads = 1;
+        views[side]->setSearchOptions(search);
+        views[side]->setSearchMemory(options.tableMB);
+        MCTSOptions mcts = players[side]->mctsOptions;
+        mcts.threads = 1;
+        views[side]->setMCTSOptions(mcts);
+    }
+    for (unsigned int ply = 0; views[0]->getWinner() < 0; ply++)
+    {
+        if (ply == MAX_GAME_PLIES)
+            return 0;
+        int side = views[0]->getTurn() - 1;
+        const TournamentPlayer<S, A> *player = players[side];
+        A move;
+        try
+        {
+            if (player->mcts)
+                move = views[side]->getMCTSMove(player->utility[side], player->maxLayer[side], player->time);
+            else
+                move = views[side]->getAIMove(player->utility[side], player->maxLayer[side], DEFAULT_DEPTH,
+                                              player->time);
+        }
+        catch (ABTimeout &)
+        {
+            ActionList<A> legal;
+            views[side]->getValidMoves(legal);
+            move = legal[0];
+            fallbackMoves++;
+        }
+        views[0]->makeMove(move);
+        views[1]->makeMove(move);
+        moves++;
+    }
+    return views[0]->getWinner();
+}
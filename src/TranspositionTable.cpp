@@ -0,0 +1,165 @@
+#pragma once
+#include "TranspositionTable.h"
+
+/*
+Constructor
+megabytes is the memory budget; the table uses the largest power-of-two
+bucket count that fits in it.
+*/
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    resize(megabytes);
+}
+
+/*
+Reallocates the table for a new memory budget.  Discards all entries.
+*/
+void TranspositionTable::resize(size_t megabytes)
+{
+    size_t bucketCount = 1;
+    while (bucketCount * 2 * sizeof(Bucket) <= (megabytes << 20))
+        bucketCount *= 2;
+    delete[] buckets;
+    buckets = new Bucket[bucketCount];
+    bucketMask = bucketCount - 1;
+    clear();
+}
+
+/*
+Empties every entry.  Not safe to call while a search is using the table.
+*/
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i <= bucketMask; i++)
+        for (unsigned int j = 0; j < ENTRIES_PER_BUCKET; j++)
+        {
+            buckets[i].keys[j].store(0, std::memory_order_relaxed);
+            buckets[i].data[j].store(0, std::memory_order_relaxed);
+        }
+    generation = 0;
+}
+
+/*
+Writes every entry to out, for read() into a table of the same size.
+Not safe to call while a search is storing into the table.
+Throws runtime_error if out fails.
+*/
+void TranspositionTable::write(std::ostream &out)
+{
+    uint64_t header[2] = {bucketMask + 1, generation};
+    out.write((const char *)header, sizeof(header));
+    out.write((const char *)buckets, (bucketMask + 1) * sizeof(Bucket));
+    if (!out)
+        throw std::runtime_error("cannot write transposition table");
+}
+
+/*
+Replaces every entry with ones written by write().
+Throws runtime_error if in fails or was written by a table of another size.
+*/
+void TranspositionTable::read(std::istream &in)
+{
+    uint64_t header[2];
+    if (!in.read((char *)header, sizeof(header)))
+        throw std::runtime_error("cannot read transposition table");
+    if (header[0] != bucketMask + 1)
+        throw std::runtime_error("transposition table was saved with another size");
+    if (!in.read((char *)buckets, (bucketMask + 1) * sizeof(Bucket)))
+    {
+        clear();
+        throw std::runtime_error("cannot read transposition table");
+    }
+    generation = header[1] & GENERATION_MASK;
+}
+
+/*
+Looks up hash.  Returns true and fills entry if found.
+*/
+bool TranspositionTable::probe(size_t hash, TTEntry &entry)
+{
+    Bucket &bucket = buckets[hash & bucketMask];
+    for (unsigned int i = 0; i < ENTRIES_PER_BUCKET; i++)
+    {
+        uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+        if (data != 0 && (bucket.keys[i].load(std::memory_order_relaxed) ^ data) == hash)
+        {
+            unpack(data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+Stores a search result.
+An existing entry for the same hash is only overwritten by a result that is
+exact, about as deep, or from a newer search.  Otherwise the bucket's empty
+entry, or the one with the lowest depth once aged by search generation, is
+replaced.
+*/
+void TranspositionTable::store(size_t hash, unsigned int depth, float value, TTBound bound,
+                               unsigned int moveIndex)
+{
+    Bucket &bucket = buckets[hash & bucketMask];
+    unsigned int replace = 0;
+    int worstScore = INT32_MAX;
+    for (unsigned int i = 0; i < ENTRIES_PER_BUCKET; i++)
+    {
+        uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+        if (data == 0) //empty
+        {
+            if (worstScore > INT32_MIN)
+            {
+                replace = i;
+                worstScore = INT32_MIN;
+            }
+            continue;
+        }
+        if ((bucket.keys[i].load(std::memory_order_relaxed) ^ data) == hash)
+        {
+            if (bound != TT_EXACT && depth + 2 < getDepth(data) && getGeneration(data) == generation)
+                return; //keep the deeper result
+            replace = i;
+            break;
+        }
+        int age = (generation - getGeneration(data)) & GENERATION_MASK;
+        int score = (int)getDepth(data) - 8 * age;
+        if (score < worstScore)
+        {
+            replace = i;
+            worstScore = score;
+        }
+    }
+    uint64_t data = pack(depth, value, bound, moveIndex, generation);
+    bucket.keys[replace].store(hash ^ data, std::memory_order_relaxed);
+    bucket.data[replace].store(data, std::memory_order_relaxed);
+}
+
+/*
+Packs an entry into 64 bits:
+value (32) | depth (8) | bound (2) | generation (6) | moveIndex (8)
+*/
+uint64_t TranspositionTable::pack(unsigned int depth, float value, TTBound bound,
+                                  unsigned int moveIndex, uint64_t generation)
+{
+    uint32_t valueBits;
+    std::memcpy(&valueBits, &value, sizeof(valueBits));
+    if (depth > 0xFF)
+        depth = 0xFF;
+    if (moveIndex > NO_MOVE_INDEX)
+        moveIndex = NO_MOVE_INDEX;
+    return (uint64_t)valueBits | (uint64_t)depth << 32 | (uint64_t)bound << 40 |
+           generation << 42 | (uint64_t)moveIndex << 48;
+}
+
+/*
+Unpacks 64 bits into entry.
+*/
+void TranspositionTable::unpack(uint64_t data, TTEntry &entry)
+{
+    uint32_t valueBits = (uint32_t)data;
+    std::memcpy(&entry.value, &valueBits, sizeof(valueBits));
+    entry.depth = getDepth(data);
+    entry.bound = (TTBound)((data >> 40) & 0x3);
+    entry.moveIndex = (data >> 48) & 0xFF;
+}
@@ -0,0 +1,84 @@
+#pragma once
+/*
+Fixed-size transposition table for alpha-beta searches.
+Holds 2^n cache-line sized buckets of entries, each storing the state hash,
+remaining search depth, value, bound type and best move.  Meant to be kept
+alive between searches so later (deeper) searches start from earlier results.
+
+Each entry is two 64-bit words stored as (key ^ data, data), so searches
+running on other threads can share one table without locks: a torn write
+simply fails the key check on probe.
+*/
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+//Defaults
+const size_t DEFAULT_TABLE_MB = 16;
+const unsigned int NO_MOVE_INDEX = 255; //entry has no best move
+
+enum TTBound : uint8_t
+{
+    TT_NONE = 0,
+    TT_EXACT, //value is the exact minimax value
+    TT_LOWER, //search failed high, value is a lower bound
+    TT_UPPER  //search failed low, value is an upper bound
+};
+
+/*
+Unpacked contents of a table entry.
+moveIndex is the position of the best action in the state's generateActions() order.
+*/
+struct TTEntry
+{
+    float value;
+    unsigned int depth;
+    TTBound bound;
+    unsigned int moveIndex;
+};
+
+class TranspositionTable
+{
+public:
+    //construct/destruct
+    TranspositionTable(size_t megabytes = DEFAULT_TABLE_MB);
+    ~TranspositionTable() { delete[] buckets; };
+
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch() { generation = (generation + 1) & GENERATION_MASK; };
+
+    bool probe(size_t hash, TTEntry &entry);
+    void store(size_t hash, unsigned int depth, float value, TTBound bound,
+               unsigned int moveIndex = NO_MOVE_INDEX);
+    void write(std::ostream &out);
+    void read(std::istream &in);
+
+    //getters
+    size_t getEntryCount() { return (bucketMask + 1) * ENTRIES_PER_BUCKET; };
+    size_t getMemory() { return (bucketMask + 1) * sizeof(Bucket); };
+
+private:
+    static const unsigned int ENTRIES_PER_BUCKET = 4;
+    static const uint64_t GENERATION_MASK = 0x3F;
+
+    struct alignas(64) Bucket
+    {
+        std::atomic<uint64_t> keys[ENTRIES_PER_BUCKET]; //hash ^ data
+        std::atomic<uint64_t> data[ENTRIES_PER_BUCKET];
+    };
+
+    Bucket *buckets = nullptr;
+    size_t bucketMask = 0;
+    uint64_t generation = 0;
+
+    static uint64_t pack(unsigned int depth, float value, TTBound bound,
+                         unsigned int moveIndex, uint64_t generation);
+    static void unpack(uint64_t data, TTEntry &entry);
+    static unsigned int getDepth(uint64_t data) { return (data >> 32) & 0xFF; };
+    static uint64_t getGeneration(uint64_t data) { return (data >> 42) & GENERATION_MASK; };
+};
+
+#include "TranspositionTable.cpp"
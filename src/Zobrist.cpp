@@ -0,0 +1,42 @@
+#pragma once
+#include "Zobrist.h"
+
+/*
+Constructor
+squares - number of squares on the board
+values - number of distinct values a square can hold (0 to values - 1)
+*/
+Zobrist::Zobrist(size_t squares, size_t values, uint64_t seed)
+    : squares{squares}, values{values}
+{
+    keys.resize(squares * values);
+    for (auto &key : keys)
+        key = splitMix64(seed);
+    sides[0] = splitMix64(seed);
+    sides[1] = splitMix64(seed);
+}
+
+/*
+Returns keys for a board shape, creating them on first use.
+*/
+std::shared_ptr<const Zobrist> Zobrist::shared(size_t squares, size_t values)
+{
+    static std::mutex lock;
+    static std::map<std::pair<size_t, size_t>, std::shared_ptr<const Zobrist>> boards;
+    std::lock_guard<std::mutex> guard(lock);
+    std::shared_ptr<const Zobrist> &keys = boards[{squares, values}];
+    if (!keys)
+        keys = std::make_shared<const Zobrist>(squares, values);
+    return keys;
+}
+
+/*
+Pseudo-random number generator for the keys.  Advances seed.
+*/
+uint64_t Zobrist::splitMix64(uint64_t &seed)
+{
+    uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
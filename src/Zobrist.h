@@ -0,0 +1,56 @@
+#pragma once
+/*
+Zobrist hashing keys for board games.
+A board is a set of squares (pits, cells, ...) that each hold a small value
+(a stone count, a piece type, ...).  The hash of a board is the XOR of
+key(square, value) over all squares, so a move only needs to XOR out the old
+key and XOR in the new one for each square it changes.
+*/
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Defaults
+const uint64_t DEFAULT_ZOBRIST_SEED = 0x9E3779B97F4A7C15ULL;
+
+class Zobrist
+{
+public:
+    //construct/destruct
+    Zobrist(size_t squares, size_t values, uint64_t seed = DEFAULT_ZOBRIST_SEED);
+
+    //Keys are shared by every board of the same shape
+    static std::shared_ptr<const Zobrist> shared(size_t squares, size_t values);
+
+    uint64_t key(size_t square, size_t value) const { return keys[square * values + value]; };
+    uint64_t sideKey(unsigned int player) const { return sides[player & 1]; };
+    //Changes hash for square going from value from to value to
+    void update(uint64_t &hash, size_t square, size_t from, size_t to) const
+    {
+        hash ^= key(square, from) ^ key(square, to);
+    };
+    //Full hash of a board, for initializing an incremental hash
+    template <class Board>
+    uint64_t hash(const Board &board) const
+    {
+        uint64_t h = 0;
+        for (size_t i = 0; i < squares; i++)
+            h ^= key(i, board[i]);
+        return h;
+    };
+
+    //getters
+    size_t getSquares() const { return squares; };
+    size_t getValues() const { return values; };
+
+private:
+    size_t squares, values;
+    std::vector<uint64_t> keys;
+    uint64_t sides[2];
+
+    static uint64_t splitMix64(uint64_t &seed);
+};
+
+#include "Zobrist.cpp"
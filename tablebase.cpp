@@ -0,0 +1,36 @@
+/*
+Generates a Mancala endgame tablebase file for Mancala::setTablebase().
+Usage: tablebase <file> [pitsPerSide] [maxStones]
+*/
+
+#include <iostream>
+#include "src/Mancala.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <file> [pitsPerSide] [maxStones]\n", argv[0]);
+        return 1;
+    }
+    size_t pitsPerSide = argc > 2 ? atoi(argv[2]) : DEFAULT_SIZE;
+    unsigned int maxStones = argc > 3 ? atoi(argv[3]) : DEFAULT_TABLEBASE_STONES;
+    try
+    {
+        //The compile-time board is faster for the standard size
+        if (pitsPerSide == DEFAULT_SIZE)
+            MancalaTablebase::generate<DefaultMancala>(argv[1], pitsPerSide, maxStones, true);
+        else
+            MancalaTablebase::generate<Mancala>(argv[1], pitsPerSide, maxStones, true);
+    }
+    catch (std::exception &e)
+    {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    MancalaTablebase tablebase(argv[1]);
+    printf("%s: %zu pits a side, up to %u stones, %zu positions\n", argv[1],
+           tablebase.getPitsPerSide(), tablebase.getMaxStones(), tablebase.getEntryCount());
+}